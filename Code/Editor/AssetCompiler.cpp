@@ -0,0 +1,744 @@
+#include "pch.h"
+#include "AssetCompiler.h"
+
+#include "OS.h"
+#include "OBJ.h"
+#include "FBX.h"
+#include "GLTF.h"
+#include "Iter.h"
+#include "Timer.h"
+#include "Assimp.h"
+#include "CVars.h"
+#include "Threading.h"
+#include "Components.h"
+
+namespace RK {
+
+bool FileHashCache::Load(const Path& inFile)
+{
+	std::ifstream file(inFile, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	uint64_t magic_number = 0;
+	uint32_t version = 0;
+	uint32_t entry_count = 0;
+	file.read((char*)&magic_number, sizeof(magic_number));
+	file.read((char*)&version, sizeof(version));
+	file.read((char*)&entry_count, sizeof(entry_count));
+
+	if (!file || magic_number != sMagicNumber || version != sVersion)
+		return false;
+
+	// a corrupt count shouldn't turn into a huge allocation, the entries have to fit in what's left of the file
+	std::error_code error_code;
+	const uint64_t file_size = fs::file_size(inFile, error_code);
+	const uint64_t header_size = sizeof(magic_number) + sizeof(version) + sizeof(entry_count);
+
+	if (error_code || file_size < header_size || uint64_t(entry_count) * sizeof(Entry) > file_size - header_size)
+		return false;
+
+	Array<Entry> entries(entry_count);
+	file.read((char*)entries.data(), entries.size() * sizeof(Entry));
+
+	if (!file)
+		return false;
+
+	std::scoped_lock lock(m_Mutex);
+
+	for (const Entry& entry : entries)
+		m_Entries[entry.pathHash] = entry;
+
+	return true;
+}
+
+
+bool FileHashCache::Save(const Path& inFile) const
+{
+	std::error_code error_code;
+	fs::create_directories(inFile.parent_path(), error_code);
+
+	std::ofstream file(inFile, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::scoped_lock lock(m_Mutex);
+
+	const uint64_t magic_number = sMagicNumber;
+	const uint32_t version = sVersion;
+	const uint32_t entry_count = uint32_t(m_UsedEntries.size());
+	file.write((const char*)&magic_number, sizeof(magic_number));
+	file.write((const char*)&version, sizeof(version));
+	file.write((const char*)&entry_count, sizeof(entry_count));
+
+	for (uint64_t path_hash : m_UsedEntries)
+		file.write((const char*)&m_Entries.at(path_hash), sizeof(Entry));
+
+	return file.good();
+}
+
+
+uint64_t FileHashCache::GetFileHash(const String& inPath)
+{
+	std::error_code error_code;
+	const uint64_t file_size = fs::file_size(inPath, error_code);
+	const int64_t write_time = fs::last_write_time(inPath, error_code).time_since_epoch().count();
+	const uint64_t path_hash = gHashFNV1a(inPath.data(), inPath.size());
+
+	{
+		std::scoped_lock lock(m_Mutex);
+
+		if (auto entry = m_Entries.find(path_hash); entry != m_Entries.end())
+		{
+			if (entry->second.fileSize == file_size && entry->second.writeTime == write_time)
+			{
+				m_UsedEntries.insert(path_hash);
+				return entry->second.contentHash;
+			}
+		}
+	}
+
+	const uint64_t content_hash = sHashFile(inPath);
+
+	std::scoped_lock lock(m_Mutex);
+	m_Entries[path_hash] = Entry { .pathHash = path_hash, .fileSize = file_size, .writeTime = write_time, .contentHash = content_hash };
+	m_UsedEntries.insert(path_hash);
+
+	return content_hash;
+}
+
+
+uint64_t FileHashCache::sHashFile(const Path& inPath)
+{
+	std::ifstream file(inPath, std::ios::binary);
+
+	static constexpr size_t sChunkSize = 1024 * 1024;
+	Array<char> chunk(sChunkSize);
+
+	XXHash64 hasher;
+
+	while (file)
+	{
+		file.read(chunk.data(), chunk.size());
+		hasher.Update(chunk.data(), file.gcount());
+	}
+
+	return hasher.Digest();
+}
+
+
+AssetCompiler::AssetCompiler()
+{
+	// read once, CVars aren't safe to touch from the jobs that convert scenes. Importers read the same one for scenes imported in the editor
+	m_OptimizeMeshes = g_CVariables ? g_CVariables->Create("optimize_meshes", 1) : true;
+
+	m_HashCache.Load(sGetHashCachePath());
+	m_DependencyGraph.Load(sGetDependencyGraphPath());
+}
+
+
+void AssetCompiler::SaveState() const
+{
+	m_HashCache.Save(sGetHashCachePath());
+	m_DependencyGraph.Save(sGetDependencyGraphPath());
+}
+
+
+void AssetCompiler::UpdateSourcesHash(FileEntry& ioFile)
+{
+	// e.g. a fresh checkout, recording the sources straight away also lets GetDependents find this scene when one of them changes
+	if (ioFile.mAssetType == ASSET_TYPE_SCENE && !m_DependencyGraph.Contains(ioFile.mAssetPath))
+		m_DependencyGraph.SetDependencies(ioFile.mAssetPath, sScanSources(ioFile), {});
+
+	const Array<String> sources = m_DependencyGraph.GetSources(ioFile.mAssetPath);
+
+	if (sources.empty())
+	{
+		ioFile.mSourcesHash = 0;
+		return;
+	}
+
+	// sources are sorted, so the hash doesn't depend on the order they were discovered in
+	XXHash64 hasher;
+
+	for (const String& source : sources)
+	{
+		const uint64_t content_hash = m_HashCache.GetFileHash(source);
+		hasher.Update(source.data(), source.size());
+		hasher.Update(&content_hash, sizeof(content_hash));
+	}
+
+	ioFile.mSourcesHash = hasher.Digest();
+}
+
+
+Array<String> AssetCompiler::sScanSources(const FileEntry& inFile)
+{
+	const Path extension = Path(inFile.mAssetPath).extension();
+
+	// FBX files and everything Assimp loads are self contained as far as the importers are concerned
+	if (extension == ".gltf")
+		return GltfImporter::sGetFileDependencies(inFile.mAssetPath);
+	else if (extension == ".obj")
+		return OBJImporter::sGetFileDependencies(inFile.mAssetPath);
+
+	return {};
+}
+
+
+void AssetCompiler::HashFiles(Array<FileEntry>& ioFiles)
+{
+	Array<Job::Ptr> jobs;
+	jobs.reserve(ioFiles.size());
+
+	for (FileEntry& file : ioFiles)
+	{
+		jobs.push_back(g_ThreadPool.QueueJob([this, &file]()
+		{
+			RefreshFile(file);
+		}));
+	}
+
+	// might be called from a job itself, WaitForJob hashes files no worker got to yet on this thread so a full pool can't deadlock on it
+	for (const Job::Ptr& job : jobs)
+		g_ThreadPool.WaitForJob(job);
+
+	m_HashCache.Save(sGetHashCachePath());
+}
+
+
+void AssetCompiler::RefreshFile(FileEntry& ioFile)
+{
+	ioFile.UpdateFileHash(m_HashCache);
+	UpdateSourcesHash(ioFile);
+
+	if (ioFile.mAssetType == ASSET_TYPE_IMAGE)
+		ioFile.mTextureUsage = m_DependencyGraph.GetTextureUsage(ioFile.mCachePath);
+
+	ioFile.UpdateCacheKey(m_OptimizeMeshes);
+	ioFile.ReadMetadata();
+}
+
+
+Array<uint32_t> AssetCompiler::RefreshReferences(Array<FileEntry>& ioFiles, const FileEntry& inScene, const std::function<bool(uint32_t)>& inIsBusy)
+{
+	Array<uint32_t> stale_files;
+
+	const Array<String> references = m_DependencyGraph.GetReferences(inScene.mAssetPath);
+
+	if (references.empty())
+		return stale_files;
+
+	for (const auto& [index, file] : gEnumerate(ioFiles))
+	{
+		if (file.mAssetType != ASSET_TYPE_IMAGE || ( inIsBusy && inIsBusy(uint32_t(index)) ))
+			continue;
+
+		// references are sorted
+		if (!std::binary_search(references.begin(), references.end(), DependencyGraph::sNormalizePath(file.mCachePath)))
+			continue;
+
+		RefreshFile(file);
+
+		if (!file.mIsCached)
+			stale_files.push_back(uint32_t(index));
+	}
+
+	return stale_files;
+}
+
+
+struct AssetCompiler::CompileBatch
+{
+	CompileBatch(uint32_t inNodeCount) : m_Pending(inNodeCount), m_Dependents(inNodeCount) {}
+
+	Array<FileEntry>* m_Files = nullptr;
+	Array<uint32_t> m_Indices;
+	Array<Atomic<uint32_t>> m_Pending; // number of unfinished references per node
+	Array<Array<uint32_t>> m_Dependents;
+	OnCompiled m_OnCompiled;
+};
+
+
+void AssetCompiler::CompileAsync(Array<FileEntry>& ioFiles, const Array<uint32_t>& inIndices, const OnCompiled& inOnCompiled)
+{
+	SharedPtr<CompileBatch> batch = std::make_shared<CompileBatch>(uint32_t(inIndices.size()));
+	batch->m_Files = &ioFiles;
+	batch->m_Indices = inIndices;
+	batch->m_OnCompiled = inOnCompiled;
+
+	// references point at cached files, map those back to the nodes that produce them
+	HashMap<String, uint32_t> nodes_by_cache_path;
+
+	for (const auto& [node, index] : gEnumerate(inIndices))
+		nodes_by_cache_path[DependencyGraph::sNormalizePath(ioFiles[index].mCachePath)] = uint32_t(node);
+
+	for (const auto& [node, index] : gEnumerate(inIndices))
+	{
+		for (const String& reference : m_DependencyGraph.GetReferences(ioFiles[index].mAssetPath))
+		{
+			auto producer = nodes_by_cache_path.find(reference);
+			if (producer == nodes_by_cache_path.end() || producer->second == node)
+				continue;
+
+			batch->m_Pending[node]++;
+			batch->m_Dependents[producer->second].push_back(uint32_t(node));
+		}
+	}
+
+	// sort topologically up front, a cycle would leave its nodes waiting forever
+	Array<uint32_t> pending(inIndices.size());
+	Array<uint32_t> ready;
+
+	for (uint32_t node = 0; node < inIndices.size(); node++)
+	{
+		pending[node] = batch->m_Pending[node].load();
+
+		if (pending[node] == 0)
+			ready.push_back(node);
+	}
+
+	const Array<uint32_t> roots = ready;
+
+	for (size_t i = 0; i < ready.size(); i++)
+	{
+		for (uint32_t dependent : batch->m_Dependents[ready[i]])
+		{
+			if (--pending[dependent] == 0)
+				ready.push_back(dependent);
+		}
+	}
+
+	if (ready.size() != inIndices.size())
+	{
+		std::cout << std::format("[Compiler] Dependency cycle between {} files, compiling them in any order.\n", inIndices.size() - ready.size());
+
+		for (uint32_t node = 0; node < inIndices.size(); node++)
+		{
+			batch->m_Dependents[node].clear();
+			batch->m_Pending[node] = 0;
+		}
+
+		for (uint32_t node = 0; node < inIndices.size(); node++)
+			QueueCompile(batch, node);
+
+		return;
+	}
+
+	for (uint32_t node : roots)
+		QueueCompile(batch, node);
+}
+
+
+void AssetCompiler::QueueCompile(const SharedPtr<CompileBatch>& inBatch, uint32_t inNode)
+{
+	g_ThreadPool.QueueJob([this, inBatch, inNode]()
+	{
+		FileEntry& file = ( *inBatch->m_Files )[inBatch->m_Indices[inNode]];
+
+		const uint64_t start_ticks = Timer::sGetCurrentTick();
+
+		bool fetched = false;
+		const bool compiled = Compile(file, fetched);
+
+		if (inBatch->m_OnCompiled)
+			inBatch->m_OnCompiled(file, compiled, fetched, Timer::sGetCurrentTick() - start_ticks);
+
+		// queued from inside the job so the thread pool never runs out of active jobs while the batch is still going
+		for (uint32_t dependent : inBatch->m_Dependents[inNode])
+		{
+			if (--inBatch->m_Pending[dependent] == 0)
+				QueueCompile(inBatch, dependent);
+		}
+	});
+}
+
+
+Array<FileEntry> AssetCompiler::sScanDirectory(const Path& inDirectory)
+{
+	Array<FileEntry> files;
+
+	std::error_code error_code;
+	for (const fs::directory_entry& file : fs::recursive_directory_iterator(inDirectory, error_code))
+	{
+		if (!file.is_regular_file())
+			continue;
+
+		if (GetCacheFileExtension(file.path()) == ASSET_TYPE_NONE)
+			continue;
+
+		files.emplace_back(file.path());
+	}
+
+	return files;
+}
+
+
+bool AssetCompiler::Compile(FileEntry& ioFile, bool& outFetched)
+{
+	// identical content was converted before, by us or by another checkout sharing the cache directory
+	outFetched = m_DerivedDataCache.Fetch(ioFile.mCacheKey, ioFile.mCachePath);
+
+	std::error_code error_code;
+
+	if (!outFetched)
+	{
+		// output of a previous conversion must not survive a failed one, it would get stamped and stored under the new key
+		fs::remove(ioFile.mCachePath, error_code);
+		fs::remove(DerivedDataCache::sGetStampPath(ioFile.mCachePath), error_code);
+
+		bool converted = false;
+
+		switch (ioFile.mAssetType)
+		{
+			case ASSET_TYPE_IMAGE:		converted = sConvertTexture(ioFile);	break;
+			case ASSET_TYPE_SCENE:		converted = ConvertScene(ioFile);		break;
+			case ASSET_TYPE_CPP_SCRIPT:	converted = sConvertScript(ioFile);		break;
+			default:															break;
+		}
+
+		if (!converted)
+		{
+			// might have written part of it
+			fs::remove(ioFile.mCachePath, error_code);
+			return false;
+		}
+
+		// the conversion might have discovered new sources, store it under the key that includes them
+		UpdateSourcesHash(ioFile);
+		ioFile.UpdateCacheKey(m_OptimizeMeshes);
+
+		m_DerivedDataCache.Store(ioFile.mCacheKey, ioFile.mCachePath);
+	}
+
+	if (!fs::is_regular_file(ioFile.mCachePath, error_code))
+		return false;
+
+	if (outFetched && ioFile.mAssetType == ASSET_TYPE_SCENE)
+		UpdateReferences(ioFile);
+
+	DerivedDataCache::sWriteStamp(ioFile.mCachePath, ioFile.mCacheKey);
+	return true;
+}
+
+
+bool AssetCompiler::sConvertTexture(const FileEntry& inFile)
+{
+	if (Path(inFile.mAssetPath).extension() != ".dds")
+		return !TextureAsset::Convert(inFile.mAssetPath, inFile.GetTextureUsage()).empty();
+
+	std::error_code error_code;
+	fs::create_directories(Path(inFile.mCachePath).parent_path(), error_code);
+	return fs::copy_file(inFile.mAssetPath, inFile.mCachePath, fs::copy_options::overwrite_existing, error_code);
+}
+
+
+bool AssetCompiler::ConvertScene(const FileEntry& inFile)
+{
+	Assets assets;
+	Scene scene(nullptr); // nullptr, dont need a renderer
+
+	const Path extension = Path(inFile.mAssetPath).extension();
+
+	bool imported = false;
+	Array<String> sources;
+
+	const auto Import = [&]<typename T>(T&& inImporter)
+	{
+		imported = inImporter.LoadFromFile(inFile.mAssetPath, nullptr);
+		sources = inImporter.GetFileDependencies();
+	};
+
+	if (extension == ".fbx")
+		Import(FBXImporter(scene, nullptr));
+	else if (extension == ".gltf")
+		Import(GltfImporter(scene, nullptr));
+	else if (extension == ".obj")
+		Import(OBJImporter(scene, nullptr));
+#ifndef DEPRECATE_ASSIMP
+	else
+		Import(AssimpImporter(scene, nullptr));
+#endif
+
+	// don't write out an empty scene
+	if (!imported)
+		return false;
+
+	m_DependencyGraph.SetDependencies(inFile.mAssetPath, sources, sGetReferences(scene));
+
+	sProcessMeshes(scene, inFile.mAssetPath, m_OptimizeMeshes);
+
+	fs::create_directories(Path(inFile.mCachePath).parent_path());
+
+	if (scene.Count<DirectionalLight>() == 0)
+		scene.Add<DirectionalLight>(scene.CreateSpatialEntity("Directional Light"));
+
+	scene.SaveToFile(inFile.mCachePath, assets);
+
+	std::error_code error_code;
+	return fs::is_regular_file(inFile.mCachePath, error_code);
+}
+
+
+Array<DependencyGraph::Reference> AssetCompiler::sGetReferences(const Scene& inScene)
+{
+	Array<DependencyGraph::Reference> references;
+
+	// the slot decides the compression format, rather than guessing it from the texture's file name
+	for (const auto& [entity, material] : inScene.Each<Material>())
+	{
+		const StaticArray<DependencyGraph::Reference, 5> slots =
+		{
+			DependencyGraph::Reference { material.albedoFile, TEXTURE_USAGE_COLOR },
+			DependencyGraph::Reference { material.normalFile, TEXTURE_USAGE_NORMAL },
+			DependencyGraph::Reference { material.emissiveFile, TEXTURE_USAGE_COLOR },
+			DependencyGraph::Reference { material.metallicFile, TEXTURE_USAGE_MASK },
+			DependencyGraph::Reference { material.roughnessFile, TEXTURE_USAGE_MASK }
+		};
+
+		for (const DependencyGraph::Reference& slot : slots)
+		{
+			if (!slot.path.empty())
+				references.push_back(slot);
+		}
+	}
+
+	return references;
+}
+
+
+void AssetCompiler::UpdateReferences(const FileEntry& inFile)
+{
+	Scene scene(nullptr);
+
+	String error;
+	if (!scene.ReadFromFile(inFile.mCachePath, error))
+	{
+		std::cout << std::format("[Compiler] Failed to read references from {}: {}\n", inFile.mCachePath, error);
+		return;
+	}
+
+	// sources were recorded by UpdateSourcesHash before the fetch, they're part of the key
+	m_DependencyGraph.SetDependencies(inFile.mAssetPath, m_DependencyGraph.GetSources(inFile.mAssetPath), sGetReferences(scene));
+}
+
+
+void AssetCompiler::sProcessMeshes(Scene& inScene, const String& inAssetPath, bool inOptimize)
+{
+	Timer timer;
+
+	struct MeshStats
+	{
+		meshopt_VertexCacheStatistics before = {};
+		meshopt_VertexCacheStatistics after = {};
+		size_t triangleCount = 0;
+		size_t vertexCountBefore = 0;
+		size_t vertexCountAfter = 0;
+		size_t meshletCount = 0;
+	};
+
+	Array<Entity> entities;
+	for (const auto& [entity, mesh] : inScene.Each<Mesh>())
+		entities.push_back(entity);
+
+	Array<MeshStats> stats(entities.size());
+
+	Array<Job::Ptr> jobs;
+	jobs.reserve(entities.size());
+
+	// meshes don't share any data, skinned ones remap their own skeleton's weights and indices
+	for (const auto& [index, entity] : gEnumerate(entities))
+	{
+		Mesh& mesh = inScene.Get<Mesh>(entity);
+		Skeleton* skeleton = inScene.GetPtr<Skeleton>(entity);
+		MeshStats& mesh_stats = stats[index];
+
+		jobs.push_back(g_ThreadPool.QueueJob([&mesh, skeleton, &mesh_stats, inOptimize]()
+		{
+			mesh_stats.triangleCount = mesh.indices.size() / 3;
+			mesh_stats.vertexCountBefore = mesh.positions.size();
+			mesh_stats.before = mesh.AnalyzeVertexCache();
+
+			if (inOptimize)
+				mesh.Optimize(skeleton);
+
+			mesh_stats.vertexCountAfter = mesh.positions.size();
+			mesh_stats.after = mesh.AnalyzeVertexCache();
+
+			// built from the final vertex order, meshlets index into the vertex buffer
+			mesh.CalculateMeshlets();
+			mesh_stats.meshletCount = mesh.meshlets.size();
+		}));
+	}
+
+	// ConvertScene runs as a compile job, WaitForJob processes the meshes no other worker picked up yet on this thread
+	for (const Job::Ptr& job : jobs)
+		g_ThreadPool.WaitForJob(job);
+
+	size_t triangle_count = 0, vertex_count_before = 0, vertex_count_after = 0, transformed_before = 0, transformed_after = 0, meshlet_count = 0;
+
+	for (const MeshStats& mesh_stats : stats)
+	{
+		triangle_count += mesh_stats.triangleCount;
+		vertex_count_before += mesh_stats.vertexCountBefore;
+		vertex_count_after += mesh_stats.vertexCountAfter;
+		transformed_before += mesh_stats.before.vertices_transformed;
+		transformed_after += mesh_stats.after.vertices_transformed;
+		meshlet_count += mesh_stats.meshletCount;
+	}
+
+	if (triangle_count == 0 || vertex_count_after == 0)
+		return;
+
+	const double elapsed_ms = Timer::sToMilliseconds(timer.GetElapsedTime());
+
+	if (inOptimize)
+	{
+		std::cout << std::format("[Assets] Optimized {} meshes of {} into {} meshlets in {:.2f} ms, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}\n", entities.size(), inAssetPath, meshlet_count, elapsed_ms,
+			float(transformed_before) / triangle_count, float(transformed_after) / triangle_count, float(transformed_before) / vertex_count_before, float(transformed_after) / vertex_count_after);
+	}
+	else
+	{
+		std::cout << std::format("[Assets] Built {} meshlets for {} meshes of {} in {:.2f} ms, ACMR {:.3f}, ATVR {:.3f}\n", meshlet_count, entities.size(), inAssetPath, elapsed_ms,
+			float(transformed_after) / triangle_count, float(transformed_after) / vertex_count_after);
+	}
+}
+
+
+bool AssetCompiler::sConvertScript(const FileEntry& inFile)
+{
+#ifdef WIN32
+	fs::create_directories(Path(inFile.mCachePath).parent_path());
+
+	const String clang_exe = "dependencies\\clang\\clang.exe";
+	const String includes = "-I source\\RK\\ -I dependencies\\BinaryRelations -I dependencies\\cgltf -I dependencies\\glm\\glm -I dependencies\\JoltPhysics -I build\\vcpkg_installed\\x64-windows-static\\include";
+	const String command = std::format("{} -gcodeview {} {} -shared -std=c++20 -o {}", clang_exe, includes, inFile.mAssetPath, inFile.mCachePath);
+
+	return OS::sCreateProcess(command.c_str());
+#else
+	// ScriptAsset loads scripts with LoadLibrary, there's nothing to build them for on other platforms
+	std::cout << std::format("[Compiler] Can't compile {}, scripts are only supported on Windows.\n", inFile.mAssetPath);
+	return false;
+#endif
+}
+
+
+int gRunHeadlessAssetCompiler(const Path& inDirectory, bool inCompileScripts)
+{
+	std::error_code error_code;
+	if (!fs::is_directory(inDirectory, error_code))
+	{
+		std::cout << std::format("[Compiler] {} is not a directory.\n", inDirectory.string());
+		return 2;
+	}
+
+	Timer timer;
+
+	g_ThreadPool.SetActiveThreadCount(g_ThreadPool.GetThreadCount());
+	stbi_set_flip_vertically_on_load(true);
+
+	AssetCompiler compiler;
+	Array<FileEntry> files = AssetCompiler::sScanDirectory(inDirectory);
+
+	// staleness is decided by content, hash everything up front
+	compiler.HashFiles(files);
+
+	std::cout << std::format("[Compiler] Scanned and hashed {} files in {:.2f} seconds.\n", files.size(), timer.Restart());
+
+	struct Stats
+	{
+		Atomic<uint32_t> m_UpToDate = 0;
+		Atomic<uint32_t> m_Fetched = 0;
+		Atomic<uint32_t> m_Converted = 0;
+		Atomic<uint32_t> m_Failed = 0;
+		Atomic<uint64_t> m_Ticks = 0; // summed over all threads
+	};
+
+	StaticArray<Stats, ASSET_TYPE_NONE> stats;
+	Array<uint32_t> stale_files;
+
+	for (const auto& [index, file] : gEnumerate(files))
+	{
+		if (file.mIsCached)
+		{
+			stats[file.mAssetType].m_UpToDate++;
+			continue;
+		}
+
+		if (file.mAssetType == ASSET_TYPE_EMBEDDED || ( file.mAssetType == ASSET_TYPE_CPP_SCRIPT && !inCompileScripts ))
+			continue;
+
+		stale_files.push_back(uint32_t(index));
+	}
+
+	const auto OnCompiled = [&stats](FileEntry& ioFile, bool inCompiled, bool inFetched, uint64_t inTicks)
+	{
+		Stats& type_stats = stats[ioFile.mAssetType];
+		type_stats.m_Ticks += inTicks;
+
+		if (!inCompiled)
+		{
+			type_stats.m_Failed++;
+			std::cout << std::format("[Compiler] Failed to convert {}\n", ioFile.mAssetPath);
+		}
+		else
+		{
+			( inFetched ? type_stats.m_Fetched : type_stats.m_Converted )++;
+			std::cout << std::format("[Compiler] {} {}\n", inFetched ? "Fetched" : "Converted", ioFile.mAssetPath);
+		}
+	};
+
+	compiler.CompileAsync(files, stale_files, OnCompiled);
+	g_ThreadPool.WaitForJobs();
+
+	// textures are converted before the scenes that reference them, so the first time around they only had their file name to go on.
+	// Scenes record the slot each texture is bound to while converting, convert the ones that turned out to be used differently again.
+	Array<uint32_t> retyped_files;
+
+	for (uint32_t index : stale_files)
+	{
+		if (files[index].mAssetType != ASSET_TYPE_SCENE)
+			continue;
+
+		// textures that failed to convert have no output, trying them again won't help
+		for (uint32_t texture : compiler.RefreshReferences(files, files[index]))
+		{
+			if (fs::is_regular_file(files[texture].mCachePath, error_code))
+				retyped_files.push_back(texture);
+		}
+	}
+
+	// scenes share textures
+	std::sort(retyped_files.begin(), retyped_files.end());
+	retyped_files.erase(std::unique(retyped_files.begin(), retyped_files.end()), retyped_files.end());
+
+	if (!retyped_files.empty())
+	{
+		compiler.CompileAsync(files, retyped_files, OnCompiled);
+		g_ThreadPool.WaitForJobs();
+	}
+
+	compiler.SaveState();
+
+	const float total_seconds = timer.GetElapsedTime();
+
+	static constexpr StaticArray<const char*, ASSET_TYPE_NONE> sTypeNames = { "Scenes", "Textures", "Embedded", "Scripts" };
+
+	uint32_t failed = 0;
+
+	std::cout << std::format("[Compiler] {:<10} {:>8} {:>8} {:>10} {:>8} {:>12}\n", "Type", "Cached", "Fetched", "Converted", "Failed", "CPU time (s)");
+
+	for (const auto& [type, type_stats] : gEnumerate(stats))
+	{
+		std::cout << std::format("[Compiler] {:<10} {:>8} {:>8} {:>10} {:>8} {:>12.2f}\n", sTypeNames[type], type_stats.m_UpToDate.load(), type_stats.m_Fetched.load(),
+			type_stats.m_Converted.load(), type_stats.m_Failed.load(), Timer::sGetTicksToSeconds(type_stats.m_Ticks.load()));
+
+		failed += type_stats.m_Failed.load();
+	}
+
+	std::cout << std::format("[Compiler] Finished in {:.2f} seconds on {} threads, {} failed.\n", total_seconds, g_ThreadPool.GetThreadCount(), failed);
+
+	return failed ? 1 : 0;
+}
+
+} // namespace RK
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "Hash.h"
+#include "Assets.h"
+#include "Components.h"
+#include "Serialization.h"
+#include "DerivedDataCache.h"
+#include "DependencyGraph.h"
+
+constexpr std::array sImageFileExtensions = {
+	".jpg", ".jpeg", ".tga", ".png", ".dds"
+};
+
+constexpr std::array sModelFileExtensions = {
+	".obj", ".gltf", ".fbx"
+};
+
+constexpr std::array sEmbededFileExtensions = {
+	".ttf"
+};
+
+constexpr std::array sCppFileExtensions = {
+	".cpp"
+};
+
+enum AssetType
+{
+	ASSET_TYPE_SCENE,
+	ASSET_TYPE_IMAGE,
+	ASSET_TYPE_EMBEDDED,
+	ASSET_TYPE_CPP_SCRIPT,
+	ASSET_TYPE_NONE
+};
+
+constexpr std::array sAssetTypeExtensions = {
+	".scene", ".dds", ".bin", ".dll"
+};
+
+namespace RK {
+
+class Scene;
+
+inline AssetType GetCacheFileExtension(const Path& inPath)
+{
+	const Path extension = inPath.extension();
+	for (const char* ext : sModelFileExtensions)
+		if (extension == ext)
+			return ASSET_TYPE_SCENE;
+
+	for (const char* ext : sImageFileExtensions)
+		if (extension == ext)
+			return ASSET_TYPE_IMAGE;
+
+	for (const char* ext : sEmbededFileExtensions)
+		if (extension == ext)
+			return ASSET_TYPE_EMBEDDED;
+
+	for (const char* ext : sCppFileExtensions)
+		if (extension == ext)
+			return ASSET_TYPE_CPP_SCRIPT;
+
+	return ASSET_TYPE_NONE;
+}
+
+/* Key of a texture converted from content inSourceHash for inUsage. The editor stamps textures it converts itself with this too,
+	so the compiler doesn't convert them again. */
+inline DerivedDataCache::Key gGetTextureCacheKey(uint64_t inSourceHash, ETextureUsage inUsage)
+{
+	return DerivedDataCache::sMakeKey(inSourceHash, "Texture", TextureAsset::sConverterVersion, ( uint64_t(inUsage) << 8 ) | MIP_FILTER_MITCHELL);
+}
+
+
+/* Remembers content hashes by path, file size and write time so unchanged files aren't read again on the next launch.
+	Thread-safe, persisted as a flat binary file next to the cached assets. */
+class FileHashCache
+{
+public:
+	static constexpr uint32_t sMagicNumber = 0x524B4648; // RKFH
+	static constexpr uint32_t sVersion = 1; // bump when the content hash changes
+
+	bool Load(const Path& inFile);
+
+	/* Only writes the entries that were looked up since Load, so deleted and renamed files drop out instead of piling up. */
+	bool Save(const Path& inFile) const;
+
+	/* Returns the cached hash for inPath, or hashes it (and caches the result) if the size or write time changed. */
+	uint64_t GetFileHash(const String& inPath);
+
+	/* Streams inPath through XXHash64 in fixed size chunks, so memory use doesn't depend on file size. */
+	static uint64_t sHashFile(const Path& inPath);
+
+private:
+	struct Entry
+	{
+		uint64_t pathHash;
+		uint64_t fileSize;
+		int64_t writeTime;
+		uint64_t contentHash;
+	};
+
+	mutable Mutex m_Mutex;
+	HashMap<uint64_t, Entry> m_Entries;
+	HashSet<uint64_t> m_UsedEntries;
+};
+
+
+struct FileEntry
+{
+	FileEntry(const Path& inAssetPath)
+		: mAssetPath(inAssetPath.string()), mAssetType(GetCacheFileExtension(inAssetPath))
+	{
+		mCachePath = Asset::GetCachedPath(mAssetPath, sAssetTypeExtensions[(int)mAssetType]);
+	}
+
+	void UpdateFileHash(FileHashCache& ioHashCache)
+	{
+		mFileHash = ioHashCache.GetFileHash(mAssetPath);
+	}
+
+	/* Key into the derived data cache: source content plus everything that changes the converter's output. */
+	void UpdateCacheKey(bool inOptimizeMeshes)
+	{
+		// files the last conversion read besides the asset itself are part of its content
+		const StaticArray<uint64_t, 2> hashes = { mFileHash, mSourcesHash };
+		const uint64_t source_hash = mSourcesHash ? gHashXXH64(hashes.data(), sizeof(hashes)) : mFileHash;
+
+		switch (mAssetType)
+		{
+			case ASSET_TYPE_IMAGE:
+			{
+				if (Path(mAssetPath).extension() == ".dds")
+					mCacheKey = DerivedDataCache::sMakeKey(source_hash, "Copy", 1);
+				else
+					mCacheKey = gGetTextureCacheKey(source_hash, GetTextureUsage());
+			} break;
+
+			case ASSET_TYPE_SCENE:
+				mCacheKey = DerivedDataCache::sMakeKey(source_hash, Path(mAssetPath).extension().string(), SceneHeader::sVersion, ( uint64_t(Mesh::sMeshletVersion) << 8 ) | ( inOptimizeMeshes ? Mesh::sOptimizerVersion : 0 ));
+				break;
+
+			default:
+				mCacheKey = DerivedDataCache::sMakeKey(source_hash, sAssetTypeExtensions[(int)mAssetType], 1);
+				break;
+		}
+	}
+
+	/* The usage recorded by the scenes that reference this texture, only falls back to guessing from the file name if there are none. */
+	ETextureUsage GetTextureUsage() const
+	{
+		return mTextureUsage != TEXTURE_USAGE_AUTO ? mTextureUsage : gGuessTextureUsage(mAssetPath);
+	}
+
+	void UpdateWriteTime()
+	{
+		String& write_path = mIsCached ? mCachePath : mAssetPath;
+		mWriteTime = std::chrono::system_clock::to_time_t(std::chrono::clock_cast<std::chrono::system_clock>( fs::last_write_time(write_path) ));
+	}
+
+	/* Up to date if the cached file was produced from the current key, write times don't matter. */
+	void ReadMetadata()
+	{
+		std::error_code error_code;
+		mIsCached = fs::is_regular_file(mCachePath, error_code) && DerivedDataCache::sReadStamp(mCachePath) == mCacheKey;
+		UpdateWriteTime();
+	}
+
+	bool mIsCached = false;
+	AssetType mAssetType = ASSET_TYPE_NONE;
+	uint64_t mFileHash = 0;
+	uint64_t mSourcesHash = 0; // combined hash of the extra source files in the dependency graph, 0 if there are none
+	uint64_t mCacheKey = 0;
+	ETextureUsage mTextureUsage = TEXTURE_USAGE_AUTO; // from the dependency graph, images only
+
+	String mAssetPath;
+	String mCachePath;
+	std::time_t mWriteTime;
+};
+
+
+/* Conversion logic shared by CompilerApp and the headless -compile_assets mode, nothing in here touches a window. Scripts are the one
+	platform specific part, they're built into a Windows DLL by running clang through OS::sCreateProcess and fail to convert elsewhere. */
+class AssetCompiler
+{
+public:
+	AssetCompiler();
+
+	/* Recursively collects every file under inDirectory that has a known asset type. */
+	static Array<FileEntry> sScanDirectory(const Path& inDirectory);
+
+	/* Materializes ioFile from the derived data cache if an entry exists, otherwise converts it and stores the result.
+		Returns false if the conversion failed, in which case there's no cached file afterwards. outFetched is set on a cache hit. */
+	bool Compile(FileEntry& ioFile, bool& outFetched);
+
+	/* Hashes every file on the thread pool (one job per file) and updates their cache keys and metadata, blocks until done. */
+	void HashFiles(Array<FileEntry>& ioFiles);
+
+	/* Rehashes a single file and its sources after it changed on disk, mIsCached is false afterwards if it needs converting. */
+	void RefreshFile(FileEntry& ioFile);
+
+	/* Refreshes the textures in ioFiles that inScene references, its conversion might have changed how they're used.
+		Skips the ones inIsBusy returns true for, returns the indices of the ones that need converting again. */
+	Array<uint32_t> RefreshReferences(Array<FileEntry>& ioFiles, const FileEntry& inScene, const std::function<bool(uint32_t)>& inIsBusy = nullptr);
+
+	using OnCompiled = std::function<void(FileEntry& ioFile, bool inCompiled, bool inFetched, uint64_t inTicks)>;
+
+	/* Compiles ioFiles[inIndices] on the thread pool in dependency order: a file is only queued once everything it references that's
+		also in inIndices is done, files without pending references run in parallel. inOnCompiled is called from the job after each file. */
+	void CompileAsync(Array<FileEntry>& ioFiles, const Array<uint32_t>& inIndices, const OnCompiled& inOnCompiled);
+
+	/* Persists the file hashes and the dependency graph, call after a batch of work. */
+	void SaveState() const;
+
+	const DependencyGraph& GetDependencyGraph() const { return m_DependencyGraph; }
+	const DerivedDataCache& GetDerivedDataCache() const { return m_DerivedDataCache; }
+
+	static Path sGetHashCachePath() { return Path("Cached") / "hashes.bin"; }
+	static Path sGetDependencyGraphPath() { return Path("Cached") / "dependencies.bin"; }
+
+private:
+	struct CompileBatch;
+	void QueueCompile(const SharedPtr<CompileBatch>& inBatch, uint32_t inNode);
+
+	/* Hashes the sources recorded for ioFile in the dependency graph into mSourcesHash. Scenes the graph doesn't know yet are scanned
+		for them first, a cache hit skips the conversion that would otherwise discover them and the key has to include them either way. */
+	void UpdateSourcesHash(FileEntry& ioFile);
+
+	/* The files an importer would report through GetFileDependencies, without importing anything. */
+	static Array<String> sScanSources(const FileEntry& inFile);
+
+	/* The textures inScene's materials use, with the usage their material slot implies. */
+	static Array<DependencyGraph::Reference> sGetReferences(const Scene& inScene);
+
+	/* A fetch skips the conversion that records the references, read them from the fetched scene instead. */
+	void UpdateReferences(const FileEntry& inFile);
+
+	/* Converters write inFile.mCachePath and return false if that failed, Compile only stores successful output in the cache. */
+	bool ConvertScene(const FileEntry& inFile);
+
+	/* Optimizes (if inOptimize) and builds meshlets for every mesh in inScene, one job per mesh, and logs the vertex cache statistics. */
+	static void sProcessMeshes(Scene& inScene, const String& inAssetPath, bool inOptimize);
+	static bool sConvertTexture(const FileEntry& inFile);
+	static bool sConvertScript(const FileEntry& inFile);
+
+	DerivedDataCache m_DerivedDataCache;
+	FileHashCache m_HashCache;
+	DependencyGraph m_DependencyGraph;
+	bool m_OptimizeMeshes = true;
+};
+
+
+/* Compiles every stale asset under inDirectory on all cores, then prints a timing summary per asset type.
+	Returns 0 if everything is up to date afterwards, 1 if any conversion failed and 2 if inDirectory doesn't exist. */
+int gRunHeadlessAssetCompiler(const Path& inDirectory, bool inCompileScripts);
+
+} // namespace RK
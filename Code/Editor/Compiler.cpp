@@ -3,13 +3,10 @@
 
 #include "OS.h"
 #include "GUI.h"
-#include "OBJ.h"
-#include "FBX.h"
-#include "GLTF.h"
 #include "Iter.h"
 #include "Timer.h"
-#include "Assimp.h"
 #include "Archive.h"
+#include "Bundle.h"
 #include "Threading.h"
 #include "Components.h"
 
@@ -73,39 +70,19 @@ CompilerApp::CompilerApp(WindowFlags inFlags) : Application(inFlags | WindowFlag
 
 	SDL_SetWindowTitle(m_Window, "RK Asset Compiler");
 
-	for (const fs::directory_entry& file : fs::recursive_directory_iterator("assets"))
-	{
-		if (!file.is_regular_file())
-			continue;
-
-		const Path path = file.path();
-		const Path extension = path.extension();
-
-		const AssetType asset_type = GetCacheFileExtension(file);
-		if (asset_type == ASSET_TYPE_NONE)
-			continue;
-
-		// if (m_Files.size() > 65)
-		//     return;
-
-		FileEntry& file_entry = m_Files.emplace_back(file);
-		file_entry.ReadMetadata();
-	}
+	m_Files = AssetCompiler::sScanDirectory("assets");
 
 	g_ThreadPool.SetActiveThreadCount(std::max(2u, g_ThreadPool.GetThreadCount() - 1));
 
+	// staleness is decided by content, so nothing gets compiled until every file is hashed
 	g_ThreadPool.QueueJob([this]() 
 	{
-		for (FileEntry& file : m_Files)
-			file.UpdateFileHash();
+		m_AssetCompiler.HashFiles(m_Files);
+		m_FilesHashed = true;
 	});
 
 	stbi_set_flip_vertically_on_load(true);
 
-	String assets_folder = fs::absolute("assets").string();
-	HANDLE change_notifs = FindFirstChangeNotificationA(assets_folder.c_str(), true, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
-	assert(change_notifs != INVALID_HANDLE_VALUE);
-
 	m_StartTicks = Timer::sGetCurrentTick();
 	m_FinishedTicks = Timer::sGetCurrentTick();
 }
@@ -144,6 +121,9 @@ void CompilerApp::OnUpdate(float inDeltaTime)
 			if (ImGui::MenuItem("Clear"))
 				fs::remove_all(fs::current_path() / "cached");
 
+			if (ImGui::MenuItem("Build Bundles"))
+				BuildBundles();
+
 			if (ImGui::MenuItem("Exit"))
 				m_Running = false;
 
@@ -386,113 +366,204 @@ void CompilerApp::OnUpdate(float inDeltaTime)
 
 	SDL_RenderPresent(m_Renderer);
 
-	for (auto [index, file] : gEnumerate(m_Files))
+	if (!m_FilesHashed)
+		return;
+
+	for (const FileChange& change : m_AssetWatcher.PollChanges())
+		m_ChangedFiles.push_back(change.path);
+
+	if (!m_ChangedFiles.empty())
+		RefreshChangedFiles();
+
+	Array<uint32_t> stale_files;
+
 	{
-		if (file.mIsCached || m_FilesInFlight.contains(index))
-			continue;
+		std::scoped_lock lock(m_FilesInFlightMutex);
 
-		if (file.mAssetType == ASSET_TYPE_IMAGE && m_CompileTextures)
+		for (auto [index, file] : gEnumerate(m_Files))
 		{
-			m_FilesInFlight.insert(index);
+			if (file.mIsCached || m_FilesInFlight.contains(index))
+				continue;
 
-			g_ThreadPool.QueueJob([this, index, &file]()
-			{
-				if (Path(file.mAssetPath).extension() != ".dds")
-				{
-					TextureAsset::Convert(file.mAssetPath);
-				}
-				else
-				{
-					fs::create_directories(Path(file.mCachePath).parent_path());
-					fs::copy_file(file.mAssetPath, file.mCachePath);
-				}
+			if (file.mAssetType == ASSET_TYPE_EMBEDDED)
+				continue;
 
-				// conversion may have failed, but we don't want to keep trying to convert, so mark as cached
-				//file.UpdateWriteTime();
-				file.mIsCached = true;
+			if (( file.mAssetType == ASSET_TYPE_IMAGE && !m_CompileTextures ) || ( file.mAssetType == ASSET_TYPE_SCENE && !m_CompileScenes ) || ( file.mAssetType == ASSET_TYPE_CPP_SCRIPT && !m_CompileScripts ))
+				continue;
 
-				std::scoped_lock lock(m_FilesInFlightMutex);
-				m_FilesInFlight.erase(index);
-				LogMessage(std::format("[Assets] Converted {}", file.mAssetPath));
-			});
+			m_FilesInFlight.insert(index);
+			stale_files.push_back(index);
 		}
-		else if (file.mAssetType == ASSET_TYPE_EMBEDDED)
+	}
+
+	if (stale_files.empty())
+		return;
+
+	// scenes wait for the textures they reference, everything else runs in parallel
+	m_AssetCompiler.CompileAsync(m_Files, stale_files, [this](FileEntry& ioFile, bool inCompiled, bool inFetched, uint64_t inTicks)
+	{
+		if (inCompiled)
+			ioFile.ReadMetadata();
+
+		// conversion may have failed, but we don't want to keep trying to convert, so mark as cached
+		ioFile.mIsCached = true;
+
+		if (inCompiled)
+			LogMessage(std::format("[Assets] {} {}", inFetched ? "Fetched" : "Converted", ioFile.mAssetPath));
+		else
+			LogMessage(std::format("[Assets] Failed to convert {}", ioFile.mAssetPath));
+
+		std::scoped_lock lock(m_FilesInFlightMutex);
+		m_FilesInFlight.erase(uint32_t(&ioFile - m_Files.data()));
+
+		// the scene recorded the slots its textures are bound to, textures converted with a different usage become stale again
+		if (inCompiled && ioFile.mAssetType == ASSET_TYPE_SCENE)
+			m_AssetCompiler.RefreshReferences(m_Files, ioFile, [this](uint32_t inIndex) { return m_FilesInFlight.contains(inIndex); });
+
+		if (m_FilesInFlight.empty())
+			m_AssetCompiler.SaveState();
+	});
+}
+
+
+void CompilerApp::RefreshChangedFiles()
+{
+	std::unique_lock lock(m_FilesInFlightMutex);
+
+	HashMap<String, uint32_t> files_by_path;
+	for (const auto& [index, file] : gEnumerate(m_Files))
+		files_by_path[DependencyGraph::sNormalizePath(file.mAssetPath)] = index;
+
+	// the watcher reports a directory when it lost track of what changed inside it (or it was moved in), check all of its files
+	Array<Path> changed_files;
+	for (const Path& path : m_ChangedFiles)
+	{
+		std::error_code error_code;
+		if (!fs::is_directory(path, error_code))
 		{
+			changed_files.push_back(path);
+			continue;
+		}
 
+		for (const fs::directory_entry& entry : fs::recursive_directory_iterator(path, error_code))
+		{
+			if (entry.is_regular_file())
+				changed_files.push_back(entry.path());
 		}
-		else if (file.mAssetType == ASSET_TYPE_CPP_SCRIPT && m_CompileScripts)
+	}
+
+	Array<Path> deferred_files;
+	Array<uint32_t> refreshed_files;
+
+	for (const Path& path : changed_files)
+	{
+		const String normalized_path = DependencyGraph::sNormalizePath(path.string());
+
+		// the file itself and every asset that read it during its last conversion
+		Array<uint32_t> affected_files;
+
+		if (auto file = files_by_path.find(normalized_path); file != files_by_path.end())
+			affected_files.push_back(file->second);
+
+		for (const String& dependent : m_AssetCompiler.GetDependencyGraph().GetDependents(normalized_path))
 		{
-			m_FilesInFlight.insert(index);
+			if (auto file = files_by_path.find(dependent); file != files_by_path.end())
+				affected_files.push_back(file->second);
+		}
 
-			g_ThreadPool.QueueJob([this, index, &file]()
-			{
-				fs::create_directories(Path(file.mCachePath).parent_path());
+		// jobs hold references to these, try again once they're done
+		if (std::any_of(affected_files.begin(), affected_files.end(), [this](uint32_t inIndex) { return m_FilesInFlight.contains(inIndex); }))
+		{
+			deferred_files.push_back(path);
+			continue;
+		}
 
-				const String clang_exe = "dependencies\\clang\\clang.exe";
-				const String includes = "-I source\\RK\\ -I dependencies\\BinaryRelations -I dependencies\\cgltf -I dependencies\\glm\\glm -I dependencies\\JoltPhysics -I build\\vcpkg_installed\\x64-windows-static\\include";
-				const String command = std::format("{} -gcodeview {} {} -shared -std=c++20 -o {}", clang_exe, includes, file.mAssetPath, file.mCachePath);
+		std::error_code error_code;
+		const bool exists = fs::is_regular_file(path, error_code);
 
-				OS::sCreateProcess(command.c_str());
+		if (affected_files.empty())
+		{
+			if (!exists || GetCacheFileExtension(path) == ASSET_TYPE_NONE)
+				continue;
 
-				file.ReadMetadata();
+			// growing the array would invalidate the references held by jobs
+			if (!m_FilesInFlight.empty())
+			{
+				deferred_files.push_back(path);
+				continue;
+			}
 
-				std::scoped_lock lock(m_FilesInFlightMutex);
-				m_FilesInFlight.erase(index);
-				LogMessage(std::format("[Assets] Converted {}", file.mAssetPath));
-			});
+			files_by_path[normalized_path] = uint32_t(m_Files.size());
+			affected_files.push_back(uint32_t(m_Files.size()));
+			m_Files.emplace_back(path);
 		}
-		else if (file.mAssetType == ASSET_TYPE_SCENE && m_CompileScenes)
+
+		for (uint32_t index : affected_files)
 		{
-			m_FilesInFlight.insert(index);
+			const FileEntry& file = m_Files[index];
 
-			g_ThreadPool.QueueJob([this, index, &file]()
+			// removed assets keep their cached output, anything referencing it still loads
+			if (!fs::is_regular_file(file.mAssetPath, error_code))
 			{
-				Assets assets;
-				Scene scene(nullptr); // nullptr, dont need a renderer
+				LogMessage(std::format("[Assets] {} was removed", file.mAssetPath));
+				continue;
+			}
 
-				const Path extension = Path(file.mAssetPath).extension();
+			// in flight until it's rehashed, so nothing compiles it with its old key in the meantime
+			if (m_FilesInFlight.insert(index).second)
+				refreshed_files.push_back(index);
+		}
+	}
 
-				if (extension == ".fbx")
-				{
-					FBXImporter importer(scene, nullptr);
-					importer.LoadFromFile(file.mAssetPath, nullptr);
-				}
-				else if (extension == ".gltf")
-				{
-					GltfImporter importer(scene, nullptr);
-					importer.LoadFromFile(file.mAssetPath, nullptr);
-				}
-				else if (extension == ".obj")
-				{
-					OBJImporter importer(scene, nullptr);
-					importer.LoadFromFile(file.mAssetPath, nullptr);
-				}
-#ifndef DEPRECATE_ASSIMP
-				else
-				{
-					auto importer = AssimpImporter(scene, nullptr);
-					importer.LoadFromFile(file.mAssetPath, nullptr);
-				}
-#endif
+	m_ChangedFiles = std::move(deferred_files);
 
-				fs::create_directories(Path(file.mCachePath).parent_path());
+	lock.unlock();
 
-				if (scene.Count<DirectionalLight>() == 0)
-					scene.Add<DirectionalLight>(scene.CreateSpatialEntity("Directional Light"));
+	// hashing reads the whole file, do it on the thread pool instead of stalling the window (and every job waiting on the lock)
+	for (uint32_t index : refreshed_files)
+	{
+		g_ThreadPool.QueueJob([this, index]()
+		{
+			FileEntry& file = m_Files[index];
 
-				scene.SaveToFile(file.mCachePath, assets);
+			m_AssetCompiler.RefreshFile(file);
 
-				file.ReadMetadata();
+			if (!file.mIsCached)
+				LogMessage(std::format("[Assets] {} changed", file.mAssetPath));
 
-				std::scoped_lock lock(m_FilesInFlightMutex);
-				m_FilesInFlight.erase(index);
-				LogMessage(std::format("[Assets] Converted {}", file.mAssetPath));
-			});
-		}
+			std::scoped_lock in_flight_lock(m_FilesInFlightMutex);
+			m_FilesInFlight.erase(index);
+
+			if (m_FilesInFlight.empty())
+				m_AssetCompiler.SaveState();
+		});
 	}
 }
 
 
+void CompilerApp::BuildBundles()
+{
+	std::error_code error_code;
+
+	for (const fs::directory_entry& entry : fs::recursive_directory_iterator("Cached", error_code))
+	{
+		if (!entry.is_regular_file() || entry.path().extension() != ".scene")
+			continue;
+
+		// keep the scene's directories, scenes with the same name in different directories would write the same bundle otherwise
+		const Path scene_file = entry.path();
+		const Path bundle_file = Path("Cached") / "Bundles" / fs::relative(scene_file, "Cached", error_code).replace_extension(".bundle");
+
+		g_ThreadPool.QueueJob([this, scene_file, bundle_file]()
+		{
+			if (gBuildSceneBundle(scene_file, bundle_file))
+				LogMessage(std::format("[Bundle] Built {}", bundle_file.string()));
+			else
+				LogMessage(std::format("[Bundle] Failed to build {}", bundle_file.string()));
+		});
+	}
+}
+
 
 void CompilerApp::OnEvent(const SDL_Event& inEvent)
 {
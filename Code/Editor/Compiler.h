@@ -2,104 +2,8 @@
 
 #include "application.h"
 #include "timer.h"
-#include "hash.h"
-
-constexpr std::array sImageFileExtensions = {
-	".jpg", ".jpeg", ".tga", ".png", ".dds"
-};
-
-constexpr std::array sModelFileExtensions = {
-	".obj", ".gltf", ".fbx"
-};
-
-constexpr std::array sEmbededFileExtensions = {
-	".ttf"
-};
-
-constexpr std::array sCppFileExtensions = {
-	".cpp"
-};
-
-enum AssetType
-{
-	ASSET_TYPE_SCENE,
-	ASSET_TYPE_IMAGE,
-	ASSET_TYPE_EMBEDDED,
-	ASSET_TYPE_CPP_SCRIPT,
-	ASSET_TYPE_NONE
-};
-
-constexpr std::array sAssetTypeExtensions = {
-	".scene", ".dds", ".bin", ".dll"
-};
-
-namespace RK {
-
-inline AssetType GetCacheFileExtension(const Path& inPath)
-{
-	const Path extension = inPath.extension();
-	for (const char* ext : sModelFileExtensions)
-		if (extension == ext)
-			return ASSET_TYPE_SCENE;
-
-	for (const char* ext : sImageFileExtensions)
-		if (extension == ext)
-			return ASSET_TYPE_IMAGE;
-
-	for (const char* ext : sEmbededFileExtensions)
-		if (extension == ext)
-			return ASSET_TYPE_EMBEDDED;
-
-	for (const char* ext : sCppFileExtensions)
-		if (extension == ext)
-			return ASSET_TYPE_CPP_SCRIPT;
-
-	return ASSET_TYPE_NONE;
-}
-
-struct FileEntry
-{
-	FileEntry(const Path& inAssetPath)
-		: mAssetPath(inAssetPath.string()), mAssetType(GetCacheFileExtension(inAssetPath))
-	{
-		mCachePath = Asset::GetCachedPath(mAssetPath, sAssetTypeExtensions[(int)mAssetType]);
-	}
-
-	void UpdateFileHash()
-	{
-		std::ifstream file(mAssetPath, std::ios::ate | std::ios::binary);
-
-		const size_t filesize = size_t(file.tellg());
-		Array<char> data = Array<char>(filesize);
-		
-		file.seekg(0);
-		file.read((char*)&data[0], filesize);
-
-		mFileHash = gHashFNV1a(data.data(), data.size());
-	}
-
-	void UpdateWriteTime()
-	{
-		String& write_path = mIsCached ? mCachePath : mAssetPath;
-		mWriteTime = std::chrono::system_clock::to_time_t(std::chrono::clock_cast<std::chrono::system_clock>( fs::last_write_time(write_path) ));
-	}
-
-	void ReadMetadata()
-	{
-		mIsCached = fs::exists(mCachePath) && fs::is_regular_file(mCachePath);
-		UpdateWriteTime();
-	}
-
-	bool mIsCached = false;
-	AssetType mAssetType = ASSET_TYPE_NONE;
-	uint64_t mFileHash = 0;
-
-	String mAssetPath;
-	String mCachePath;
-	std::time_t mWriteTime;
-};
-
-}
+#include "AssetCompiler.h"
+#include "FileWatcher.h"
 
 namespace RK {
 
@@ -117,6 +21,13 @@ public:
 	HWND GetWindowHandle();
 
 private:
+	/* Packs every compiled scene and the textures it references into Cached/Bundles/<path relative to Cached>.bundle. */
+	void BuildBundles();
+
+	/* Rehashes the files the watcher reported and every asset that depends on them on the thread pool, they count as in flight until that's done.
+		Paths that touch files already in flight wait for the next frame. */
+	void RefreshChangedFiles();
+
 	uint64_t m_StartTicks = 0;
 	uint64_t m_FinishedTicks = 0;
 	Path m_CurrentPath;
@@ -132,6 +43,10 @@ private:
 	std::atomic<bool> m_CompileScenes = true;
 	std::atomic<bool> m_CompileScripts = false;
 	std::atomic<bool> m_CompileTextures = true;
+	std::atomic<bool> m_FilesHashed = false;
+	AssetCompiler m_AssetCompiler;
+	FileWatcher m_AssetWatcher { "assets" };
+	Array<Path> m_ChangedFiles;
 };
 
 
@@ -0,0 +1,244 @@
+#include "pch.h"
+#include "DependencyGraph.h"
+
+namespace RK {
+
+static void sWriteString(std::ofstream& ioFile, const String& inString)
+{
+	const uint32_t length = uint32_t(inString.size());
+	ioFile.write((const char*)&length, sizeof(length));
+	ioFile.write(inString.data(), length);
+}
+
+
+static void sReadString(std::ifstream& ioFile, String& outString)
+{
+	uint32_t length = 0;
+	ioFile.read((char*)&length, sizeof(length));
+
+	outString.resize(ioFile ? length : 0);
+	ioFile.read(outString.data(), outString.size());
+}
+
+
+static void sWriteStrings(std::ofstream& ioFile, const Array<String>& inStrings)
+{
+	const uint32_t count = uint32_t(inStrings.size());
+	ioFile.write((const char*)&count, sizeof(count));
+
+	for (const String& string : inStrings)
+		sWriteString(ioFile, string);
+}
+
+
+static void sReadStrings(std::ifstream& ioFile, Array<String>& outStrings)
+{
+	uint32_t count = 0;
+	ioFile.read((char*)&count, sizeof(count));
+
+	for (uint32_t i = 0; i < count && ioFile; i++)
+		sReadString(ioFile, outStrings.emplace_back());
+}
+
+
+static void sWriteBytes(std::ofstream& ioFile, const Array<uint8_t>& inBytes)
+{
+	const uint32_t count = uint32_t(inBytes.size());
+	ioFile.write((const char*)&count, sizeof(count));
+	ioFile.write((const char*)inBytes.data(), count);
+}
+
+
+static void sReadBytes(std::ifstream& ioFile, Array<uint8_t>& outBytes)
+{
+	uint32_t count = 0;
+	ioFile.read((char*)&count, sizeof(count));
+
+	outBytes.resize(ioFile ? count : 0);
+	ioFile.read((char*)outBytes.data(), outBytes.size());
+}
+
+
+String DependencyGraph::sNormalizePath(StringView inPath)
+{
+	String path = Path(inPath).lexically_normal().generic_string();
+	std::transform(path.begin(), path.end(), path.begin(), [](char c) { return char(std::tolower(uint8_t(c))); });
+
+	return path;
+}
+
+
+bool DependencyGraph::Load(const Path& inFile)
+{
+	std::ifstream file(inFile, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	uint64_t magic_number = 0;
+	uint32_t version = 0;
+	uint32_t node_count = 0;
+	file.read((char*)&magic_number, sizeof(magic_number));
+	file.read((char*)&version, sizeof(version));
+	file.read((char*)&node_count, sizeof(node_count));
+
+	if (!file || magic_number != sMagicNumber || version != sVersion)
+		return false;
+
+	HashMap<String, Node> nodes;
+
+	for (uint32_t i = 0; i < node_count && file; i++)
+	{
+		String asset;
+		sReadString(file, asset);
+
+		Node& node = nodes[asset];
+		sReadStrings(file, node.sources);
+		sReadStrings(file, node.references);
+		sReadBytes(file, node.usages);
+
+		if (node.usages.size() != node.references.size())
+			file.setstate(std::ios::failbit);
+	}
+
+	// truncated file, better to rediscover everything than to trust half a graph
+	if (!file)
+		return false;
+
+	std::scoped_lock lock(m_Mutex);
+	m_Nodes = std::move(nodes);
+
+	return true;
+}
+
+
+bool DependencyGraph::Save(const Path& inFile) const
+{
+	std::error_code error_code;
+	fs::create_directories(inFile.parent_path(), error_code);
+
+	std::ofstream file(inFile, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::scoped_lock lock(m_Mutex);
+
+	const uint64_t magic_number = sMagicNumber;
+	const uint32_t version = sVersion;
+	const uint32_t node_count = uint32_t(m_Nodes.size());
+	file.write((const char*)&magic_number, sizeof(magic_number));
+	file.write((const char*)&version, sizeof(version));
+	file.write((const char*)&node_count, sizeof(node_count));
+
+	for (const auto& [asset, node] : m_Nodes)
+	{
+		sWriteString(file, asset);
+		sWriteStrings(file, node.sources);
+		sWriteStrings(file, node.references);
+		sWriteBytes(file, node.usages);
+	}
+
+	return file.good();
+}
+
+
+void DependencyGraph::SetDependencies(const String& inAsset, const Array<String>& inSources, const Array<Reference>& inReferences)
+{
+	Node node;
+
+	for (const String& source : inSources)
+		node.sources.push_back(sNormalizePath(source));
+
+	// formats can list the same buffer twice
+	std::sort(node.sources.begin(), node.sources.end());
+	node.sources.erase(std::unique(node.sources.begin(), node.sources.end()), node.sources.end());
+
+	Array<Pair<String, uint8_t>> references;
+	for (const Reference& reference : inReferences)
+		references.emplace_back(sNormalizePath(reference.path), uint8_t(reference.usage));
+
+	// materials share textures, sorting by usage second keeps the lowest usage of each texture
+	std::sort(references.begin(), references.end());
+	references.erase(std::unique(references.begin(), references.end(), [](const auto& inLHS, const auto& inRHS) { return inLHS.first == inRHS.first; }), references.end());
+
+	for (const auto& [path, usage] : references)
+	{
+		node.references.push_back(path);
+		node.usages.push_back(usage);
+	}
+
+	std::scoped_lock lock(m_Mutex);
+	m_Nodes[sNormalizePath(inAsset)] = std::move(node);
+}
+
+
+bool DependencyGraph::Contains(const String& inAsset) const
+{
+	std::scoped_lock lock(m_Mutex);
+	return m_Nodes.contains(sNormalizePath(inAsset));
+}
+
+
+Array<String> DependencyGraph::GetSources(const String& inAsset) const
+{
+	std::scoped_lock lock(m_Mutex);
+
+	if (auto node = m_Nodes.find(sNormalizePath(inAsset)); node != m_Nodes.end())
+		return node->second.sources;
+
+	return {};
+}
+
+
+Array<String> DependencyGraph::GetReferences(const String& inAsset) const
+{
+	std::scoped_lock lock(m_Mutex);
+
+	if (auto node = m_Nodes.find(sNormalizePath(inAsset)); node != m_Nodes.end())
+		return node->second.references;
+
+	return {};
+}
+
+
+ETextureUsage DependencyGraph::GetTextureUsage(const String& inCachedFile) const
+{
+	const String file = sNormalizePath(inCachedFile);
+
+	ETextureUsage texture_usage = TEXTURE_USAGE_AUTO;
+
+	std::scoped_lock lock(m_Mutex);
+
+	for (const auto& [asset, node] : m_Nodes)
+	{
+		const auto reference = std::lower_bound(node.references.begin(), node.references.end(), file);
+		if (reference == node.references.end() || *reference != file)
+			continue;
+
+		const ETextureUsage usage = ETextureUsage(node.usages[reference - node.references.begin()]);
+
+		if (usage != TEXTURE_USAGE_AUTO && ( texture_usage == TEXTURE_USAGE_AUTO || usage < texture_usage ))
+			texture_usage = usage;
+	}
+
+	return texture_usage;
+}
+
+
+Array<String> DependencyGraph::GetDependents(const String& inFile) const
+{
+	const String file = sNormalizePath(inFile);
+
+	Array<String> dependents;
+
+	std::scoped_lock lock(m_Mutex);
+
+	for (const auto& [asset, node] : m_Nodes)
+	{
+		if (std::binary_search(node.sources.begin(), node.sources.end(), file))
+			dependents.push_back(asset);
+	}
+
+	return dependents;
+}
+
+} // namespace RK
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "TextureCompression.h"
+
+namespace RK {
+
+/* Edges the asset compiler discovers while converting, keyed by source asset path.
+	Sources are files a conversion read besides the asset itself (GLTF buffers, OBJ material libraries), their content is part of the asset's cache key.
+	References are cached files the output points to (a scene's textures), those get converted first but changing them doesn't invalidate the output.
+	Each reference also records how the output uses it (the material slot a texture is bound to), which picks the texture's compression format.
+	Thread-safe, persisted next to the cached assets so the next launch knows every edge before converting anything. */
+class DependencyGraph
+{
+public:
+	static constexpr uint32_t sMagicNumber = 0x524B4447; // RKDG
+	static constexpr uint32_t sVersion = 2;
+
+	bool Load(const Path& inFile);
+	bool Save(const Path& inFile) const;
+
+	struct Reference
+	{
+		String path;
+		ETextureUsage usage = TEXTURE_USAGE_AUTO;
+	};
+
+	/* Replaces the edges of inAsset, called after every conversion. */
+	void SetDependencies(const String& inAsset, const Array<String>& inSources, const Array<Reference>& inReferences);
+
+	/* True if inAsset has edges, i.e. it was converted (or scanned for sources) before. */
+	bool Contains(const String& inAsset) const;
+
+	Array<String> GetSources(const String& inAsset) const;
+	Array<String> GetReferences(const String& inAsset) const;
+
+	/* How the assets referencing inCachedFile use it, TEXTURE_USAGE_AUTO if none of them said. A texture bound to different kinds of
+		slots gets the lowest usage (color), block compressing for color never destroys data the other usages need. */
+	ETextureUsage GetTextureUsage(const String& inCachedFile) const;
+
+	/* Assets that read inFile during their last conversion, they need to be rebuilt when it changes. */
+	Array<String> GetDependents(const String& inFile) const;
+
+	/* Lower case, forward slashes and no . or .. parts, so differently spelled paths to the same file compare equal. */
+	static String sNormalizePath(StringView inPath);
+
+private:
+	struct Node
+	{
+		Array<String> sources;
+		Array<String> references;
+		Array<uint8_t> usages; // ETextureUsage per reference
+	};
+
+	mutable Mutex m_Mutex;
+	HashMap<String, Node> m_Nodes;
+};
+
+} // namespace RK
@@ -153,6 +153,13 @@ void Editor::OnUpdate(float inDeltaTime)
     // update relative mouse mode
     SDL_SetWindowRelativeMouseMode(m_Window, g_Input->IsRelativeMouseMode());
 
+	// swap in and upload any scene that is being streamed in, whatever was selected belongs to the scene that got swapped out
+	if (m_Scene.UpdateStreaming())
+	{
+		SetActiveEntity(Entity::Null);
+		m_Selection.Clear();
+	}
+
 	// update the physics system
 	m_Physics.OnUpdate(m_Scene);
 
@@ -305,19 +312,17 @@ void Editor::OnEvent(const SDL_Event& event)
 			{
 				if (g_Input->IsKeyDown(Key::LCTRL))
 				{
-					String filepath = OS::sSaveFileDialog("Scene File (*.scene)\0", "scene");
+					// quick save to the scene we opened or saved last, only ask for a path the first time
+					String filepath = m_Scene.GetActiveSceneFilePath().string();
+
+					if (filepath.empty())
+						filepath = OS::sSaveFileDialog("Scene File (*.scene)\0", "scene");
 
 					if (!filepath.empty())
 					{
-						g_ThreadPool.QueueJob([this, filepath]()
-						{
-							LogMessage("[Editor] Saving scene...");
-							m_Scene.SaveToFile(filepath, m_Assets);
-							LogMessage("[Editor] Saved scene to " + fs::relative(filepath).string() + "");
-						});
+						m_Scene.SaveToFileAsync(filepath, m_Assets, this);
+						AddRecentScene(filepath);
 					}
-
-					AddRecentScene(filepath);
 				}
 			} break;
 
@@ -83,7 +83,7 @@ bool HierarchyWidget::DrawFamilyNode(Scene& inScene, Entity inEntity)
 {
 	ImGuiSelectionBasicStorage& multi_select = m_Editor->GetMultiSelect();
 
-	const String name = inScene.Has<Name>(inEntity) ? inScene.Get<Name>(inEntity).name : "N/A";
+	const String name = inScene.Has<Name>(inEntity) ? std::as_const(inScene).Get<Name>(inEntity).name : "N/A";
 	const Entity active = m_Editor->GetActiveEntity();
 	const bool is_selected = active == inEntity || multi_select.Contains(inEntity);
 
@@ -143,7 +143,7 @@ void HierarchyWidget::DrawChildlessNode(Scene& inScene, Entity inEntity)
 
 	//ImGui::SameLine();
 
-	String name = inScene.Has<Name>(inEntity) ? inScene.Get<Name>(inEntity).name : "N/A";
+	String name = inScene.Has<Name>(inEntity) ? std::as_const(inScene).Get<Name>(inEntity).name : "N/A";
 
 	ImGui::SetNextItemSelectionUserData(inEntity);
 
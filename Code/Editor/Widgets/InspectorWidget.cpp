@@ -13,6 +13,7 @@
 #include "Animation.h"
 #include "Components.h"
 #include "Application.h"
+#include "AssetCompiler.h"
 #include "DebugRenderer.h"
 #include "Renderer/Shared.h"
 
@@ -93,7 +94,17 @@ bool InspectorWidget::DrawEntityInspector(Widgets* inWidgets)
 					ImGui::PopStyleVar();
 
 					if (is_open) 
-						scene_changed |= DrawComponent(entity, scene.Get<ComponentType>(entity));
+					{
+						ImGui::BeginGroup();
+						const bool changed = DrawComponent(entity, scene.GetUntracked<ComponentType>(entity));
+						ImGui::EndGroup();
+
+						// not every DrawComponent reports its edits, so also treat any widget in the group being edited or released as a change
+						if (changed || ImGui::IsItemEdited() || ImGui::IsItemDeactivated())
+							scene.MarkDirty<ComponentType>();
+
+						scene_changed |= changed;
+					}
 				}
 				else
 					ImGui::PopStyleVar();
@@ -266,7 +277,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Mesh& ioMesh)
 
 	if (scene.Has<Material>(ioMesh.material) && scene.Has<Material, Name>(ioMesh.material))
 	{
-		const auto& [material, name] = scene.Get<Material, Name>(ioMesh.material);
+		const auto& [material, name] = std::as_const(scene).Get<Material, Name>(ioMesh.material);
 
 		const uint64_t albedo_imgui_id = m_Editor->GetRenderInterface()->GetImGuiTextureID(material.gpuAlbedoMap);
 		const ImVec4 tint_color = ImVec4(material.albedo.r, material.albedo.g, material.albedo.b, material.albedo.a);
@@ -476,8 +487,8 @@ bool InspectorWidget::DrawComponent(Entity inEntity, SoftBody& ioSoftBody)
 
 	ImGui::Text("Unique Body ID: %i", ioSoftBody.mBodyID.GetIndexAndSequenceNumber());
 
-	Mesh& mesh = GetScene().Get<Mesh>(inEntity);
-	Transform& transform = GetScene().Get<Transform>(inEntity);
+	const Mesh& mesh = std::as_const(GetScene()).Get<Mesh>(inEntity);
+	const Transform& transform = std::as_const(GetScene()).Get<Transform>(inEntity);
 
 	if (ImGui::Button("Build"))
 	{
@@ -638,6 +649,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, RigidBody& inRigidBody)
 
 bool InspectorWidget::DrawComponent(Entity inEntity, Skeleton& inSkeleton)
 {
+	bool changed = false;
 	uint32_t bone_count = 0;
 
 	auto CountBone = [&](auto&& CountBone, Skeleton::Bone& inBone) -> void
@@ -670,7 +682,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Skeleton& inSkeleton)
 	Scene& scene = GetScene();
 	if (scene.Has<Animation>(inSkeleton.animation) && scene.Has<Animation, Name>(inSkeleton.animation))
 	{
-		const auto& [animation, name] = scene.Get<Animation, Name>(inSkeleton.animation);
+		const auto& [animation, name] = std::as_const(scene).Get<Animation, Name>(inSkeleton.animation);
 
 		if (ImGui::DragDropTargetButton("Animation", name.name.c_str(), true))
 			SetActiveEntity(inSkeleton.animation);
@@ -685,7 +697,10 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Skeleton& inSkeleton)
 			Entity entity = *reinterpret_cast<const Entity*>( payload->Data );
 
 			if (scene.Has<Animation>(entity))
+			{
 				inSkeleton.animation = entity;
+				changed = true;
+			}
 		}
 
 		ImGui::EndDragDropTarget();
@@ -693,7 +708,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Skeleton& inSkeleton)
 
     if (ImGui::BeginPopupContextItem())
     {
-        for (const auto& [entity, animation] : GetScene().Each<Animation>())
+        for (const auto& [entity, animation] : std::as_const(GetScene()).Each<Animation>())
         {
             if (ImGui::MenuItem(animation.GetName().c_str()))
             {
@@ -728,7 +743,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Skeleton& inSkeleton)
 		}
 	}
 
-	return false;
+	return changed;
 }
 
 
@@ -859,7 +874,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Material& inMaterial)
 			ImGui::PopStyleColor();
 	};
 
-	auto DrawTextureInteraction = [&](uint32_t& inGpuMap, uint8_t& inSwizzle, uint32_t inDefaultMap, String& inFile, uint32_t& imguiID)
+	auto DrawTextureInteraction = [&](uint32_t& inGpuMap, uint8_t& inSwizzle, uint32_t inDefaultMap, String& inFile, TextureAsset::Ptr& ioAsset, uint32_t& imguiID)
 	{
 		/*ImGui::PushID(imguiID++);
 		DrawSwizzleChannel("R", inSwizzle, TEXTURE_SWIZZLE_RRRR);
@@ -891,15 +906,27 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Material& inMaterial)
 
 			if (!filepath.empty())
 			{
-				const String asset_path = TextureAsset::Convert(filepath);
+				ETextureUsage usage = TEXTURE_USAGE_COLOR;
+				if (&inGpuMap == &inMaterial.gpuNormalMap)
+					usage = TEXTURE_USAGE_NORMAL;
+				else if (&inGpuMap == &inMaterial.gpuMetallicMap || &inGpuMap == &inMaterial.gpuRoughnessMap)
+					usage = TEXTURE_USAGE_MASK;
+
+				// drop the registry's copy first, it keeps the old .dds mapped and would be handed back instead of the new one
+				GetAssets().ReleaseAsset(TextureAsset::GetCachedPath(filepath));
+
+				const String asset_path = TextureAsset::Convert(filepath, usage);
 
 				if (!asset_path.empty())
 				{
+					// stamp it the way the compiler would, otherwise it converts the file again with the usage it guessed
+					DerivedDataCache::sWriteStamp(asset_path, gGetTextureCacheKey(FileHashCache::sHashFile(filepath), usage));
+
 					inFile = asset_path;
 					const bool is_srgb = inGpuMap == inMaterial.gpuAlbedoMap;
 
-					TextureAsset::Ptr asset = GetAssets().GetAsset<TextureAsset>(asset_path);
-					inGpuMap = m_Editor->GetRenderInterface()->UploadTextureFromAsset(asset, is_srgb);
+					ioAsset = GetAssets().GetAsset<TextureAsset>(asset_path);
+					inGpuMap = m_Editor->GetRenderInterface()->UploadTextureFromAsset(ioAsset, is_srgb);
 				}
 				else
 					ImGui::OpenPopup("Error");
@@ -921,6 +948,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Material& inMaterial)
 
 				inFile = "";
 				inGpuMap = inDefaultMap;
+				ioAsset = nullptr;
 				scene_changed = true;
 
 				m_MaterialUndo.current = inMaterial;
@@ -950,15 +978,15 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Material& inMaterial)
 	uint32_t imgui_id = 0;
 
 	ImGui::AlignTextToFramePadding(); ImGui::Text("Albedo Map       "); ImGui::SameLine();
-	DrawTextureInteraction(inMaterial.gpuAlbedoMap, inMaterial.gpuAlbedoMapSwizzle, Material::Default.gpuAlbedoMap, inMaterial.albedoFile, ++imgui_id);
+	DrawTextureInteraction(inMaterial.gpuAlbedoMap, inMaterial.gpuAlbedoMapSwizzle, Material::Default.gpuAlbedoMap, inMaterial.albedoFile, inMaterial.albedoAsset, ++imgui_id);
 	ImGui::AlignTextToFramePadding(); ImGui::Text("Normal Map       "); ImGui::SameLine();
-	DrawTextureInteraction(inMaterial.gpuNormalMap, inMaterial.gpuNormalMapSwizzle, Material::Default.gpuNormalMap, inMaterial.normalFile, ++imgui_id);
+	DrawTextureInteraction(inMaterial.gpuNormalMap, inMaterial.gpuNormalMapSwizzle, Material::Default.gpuNormalMap, inMaterial.normalFile, inMaterial.normalAsset, ++imgui_id);
 	ImGui::AlignTextToFramePadding(); ImGui::Text("Emissive Map    "); ImGui::SameLine();
-	DrawTextureInteraction(inMaterial.gpuEmissiveMap, inMaterial.gpuEmissiveMapSwizzle, Material::Default.gpuEmissiveMap, inMaterial.emissiveFile, ++imgui_id);
+	DrawTextureInteraction(inMaterial.gpuEmissiveMap, inMaterial.gpuEmissiveMapSwizzle, Material::Default.gpuEmissiveMap, inMaterial.emissiveFile, inMaterial.emissiveAsset, ++imgui_id);
 	ImGui::AlignTextToFramePadding(); ImGui::Text("Metallic Map      "); ImGui::SameLine();
-	DrawTextureInteraction(inMaterial.gpuMetallicMap, inMaterial.gpuMetallicMapSwizzle, Material::Default.gpuMetallicMap, inMaterial.metallicFile, ++imgui_id);
+	DrawTextureInteraction(inMaterial.gpuMetallicMap, inMaterial.gpuMetallicMapSwizzle, Material::Default.gpuMetallicMap, inMaterial.metallicFile, inMaterial.metallicAsset, ++imgui_id);
 	ImGui::AlignTextToFramePadding(); ImGui::Text("Roughness Map"); ImGui::SameLine();
-	DrawTextureInteraction(inMaterial.gpuRoughnessMap, inMaterial.gpuRoughnessMapSwizzle, Material::Default.gpuRoughnessMap, inMaterial.roughnessFile, ++imgui_id);
+	DrawTextureInteraction(inMaterial.gpuRoughnessMap, inMaterial.gpuRoughnessMapSwizzle, Material::Default.gpuRoughnessMap, inMaterial.roughnessFile, inMaterial.roughnessAsset, ++imgui_id);
 
 	/* for (const auto& [index, texture] : gEnumerate(inMaterial.textures))
 	{
@@ -1016,7 +1044,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Transform& inTransform)
 
 	ImGui::Separator();
 
-	const Animation* animation = GetScene().GetPtr<Animation>(inTransform.animation);
+	const Animation* animation = std::as_const(GetScene()).GetPtr<Animation>(inTransform.animation);
 	const String preview_text = animation ? animation->GetName() : "None";
 
 	if (ImGui::DragDropTargetButton("Animation", preview_text.c_str(), animation != nullptr))
@@ -1038,7 +1066,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, Transform& inTransform)
 
     if (ImGui::BeginPopupContextItem())
     {
-        for (const auto& [entity, animation] : GetScene().Each<Animation>())
+        for (const auto& [entity, animation] : std::as_const(GetScene()).Each<Animation>())
         {
             if (ImGui::MenuItem(animation.GetName().c_str()))
             {
@@ -1272,7 +1300,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, NativeScript& inScript)
 
 bool InspectorWidget::DrawComponent(Entity inEntity, DDGISceneSettings& ioSettings)
 {
-	const Transform& transform = GetScene().Get<Transform>(GetActiveEntity());
+	const Transform& transform = std::as_const(GetScene()).Get<Transform>(GetActiveEntity());
 
 	const Vec3 min_bounds = transform.GetPositionWorldSpace();
 	const Vec3 max_bounds = min_bounds + ioSettings.mDDGIProbeSpacing * Vec3(ioSettings.mDDGIProbeCount);
@@ -1318,6 +1346,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, DirectionalLight& inDirecti
 		{
 			inDirectionalLight.cubeMap = 0;
 			inDirectionalLight.cubeMapFile = "";
+			inDirectionalLight.cubeMapAsset = nullptr;
 			m_Editor->GetRenderInterface()->OnResize(m_Editor->GetViewport()); // trigger a rendergraph recompile.. TODO FIXME
 		}
 
@@ -1343,6 +1372,7 @@ bool InspectorWidget::DrawComponent(Entity inEntity, DirectionalLight& inDirecti
 				inDirectionalLight.cubeMapFile = asset_path;
 				TextureAsset::Ptr asset = GetAssets().GetAsset<TextureAsset>(asset_path);
 				inDirectionalLight.cubeMap = m_Editor->GetRenderInterface()->UploadTextureFromAsset(asset);
+				inDirectionalLight.cubeMapAsset = asset;
 				m_Editor->GetRenderInterface()->OnResize(m_Editor->GetViewport()); // trigger a rendergraph recompile.. TODO FIXME
 			}
 			else
@@ -51,7 +51,10 @@ void MenubarWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 		{
 			if (ImGui::MenuItem("New scene"))
 			{
+				// a scene still streaming in would replace the new one a few frames later
+				scene.CancelStreaming();
 				scene.Clear();
+				scene.SetActiveSceneFilePath({});
 				m_Editor->SetActiveEntity(Entity::Null);
 			}
 
@@ -61,16 +64,12 @@ void MenubarWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
 				if (!filepath.empty())
 				{
-					Timer timer;
 					SDL_SetWindowTitle(m_Editor->GetWindow(), std::string("RK Editor - " + filepath).c_str());
 
-					scene.OpenFromFile(filepath, IWidget::GetAssets(), m_Editor);
+					// the selection is cleared once the scene is swapped in, until then it still belongs to the live scene
+					scene.OpenFromFileAsync(filepath, IWidget::GetAssets(), m_Editor);
 
 					m_Editor->AddRecentScene(filepath);
-
-					m_Editor->SetActiveEntity(Entity::Null);
-
-					m_Editor->LogMessage("[Scene] Open from file took " + std::to_string(Timer::sToMilliseconds(timer.GetElapsedTime())) + " ms.");
 				}
 			}
 
@@ -80,15 +79,9 @@ void MenubarWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
 				if (!filepath.empty())
 				{
-					g_ThreadPool.QueueJob([this, filepath]()
-					{
-						m_Editor->LogMessage("[Editor] Saving scene...");
-						GetScene().SaveToFile(filepath, IWidget::GetAssets());
-						m_Editor->LogMessage("[Editor] Saved scene to " + fs::relative(filepath).string() + "");
-					});
+					scene.SaveToFileAsync(filepath, IWidget::GetAssets(), m_Editor);
+					m_Editor->AddRecentScene(filepath);
 				}
-
-				m_Editor->AddRecentScene(filepath);
 			}
 
 			if (ImGui::MenuItem("Import scene.."))
@@ -99,6 +92,8 @@ void MenubarWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 				{
 					Timer timer;
 
+					// imports into the live scene, which a scene still streaming in would replace
+					scene.CancelStreaming();
 					m_Editor->SetActiveEntity(Entity::Null);
 
 					const Path extension = fs::path(filepath).extension();
@@ -138,7 +133,7 @@ void MenubarWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 						{
 							if (fs::exists(scene_str))
 							{
-								m_Editor->GetScene()->OpenFromFile(scene_str, IWidget::GetAssets(), m_Editor);
+								m_Editor->GetScene()->OpenFromFileAsync(scene_str, IWidget::GetAssets(), m_Editor);
 
 								m_Editor->AddRecentScene(scene_str);
 
@@ -415,6 +410,16 @@ void MenubarWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
 		ImGui::PopID();
 
+		if (SceneStreamingRequest::Ptr request = scene.GetStreamingRequest())
+		{
+			ImGui::Separator();
+			ImGui::Text("Loading %s..", request->GetPath().filename().string().c_str());
+			ImGui::ProgressBar(request->GetProgress(), ImVec2(150.0f, 0.0f));
+
+			if (request->GetState() < SceneStreamingRequest::STREAMING_UPLOADING && ImGui::SmallButton("Cancel"))
+				scene.CancelStreaming();
+		}
+
 		ImGui::EndMainMenuBar();
 	}
 }
@@ -66,7 +66,7 @@ void SequenceWidget::Draw(Widgets* inWidgets, float inDeltaTime)
     if (m_ActiveAnimationEntity != Entity::Null)
     {
         if (GetScene().Has<Animation>(m_ActiveAnimationEntity))
-            sequence_animation_preview_text = GetScene().Get<Animation>(m_ActiveAnimationEntity).GetName().c_str();
+            sequence_animation_preview_text = std::as_const(GetScene()).Get<Animation>(m_ActiveAnimationEntity).GetName().c_str();
         else
             m_ActiveAnimationEntity = Entity::Null;
     }
@@ -74,7 +74,7 @@ void SequenceWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
     if (ImGui::BeginCombo("##SequenceAnimationCombo", sequence_animation_preview_text))
     {
-        for (const auto& [entity, animation] : GetScene().Each<Animation>())
+        for (const auto& [entity, animation] : std::as_const(GetScene()).Each<Animation>())
         {
             if (ImGui::Selectable(animation.GetName().c_str(), m_ActiveAnimationEntity == entity))
             {
@@ -106,20 +106,21 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 		{
 			if (scene.Has<Transform>(parent))
 			{
-				const Transform& parent_transform = scene.Get<Transform>(parent);
+				const Transform& parent_transform = std::as_const(scene).Get<Transform>(parent);
 				local_to_world_transform = parent_transform.worldTransform;
 				world_to_local_transform = glm::inverse(parent_transform.worldTransform);
 			}
 		}
 
-		Transform& transform = scene.Get<Transform>(GetActiveEntity());
+		// the gizmo is drawn every frame but only marks the storage dirty when it actually moved something
+		Transform& transform = scene.GetUntracked<Transform>(GetActiveEntity());
 		Mat4x4 world_space_transform = local_to_world_transform * transform.localTransform;
 
 		Vec3 additional_translation = Vec3(0.0f);
 
 		if (scene.Has<Mesh>(GetActiveEntity()))
 		{
-			const Mesh& mesh = scene.Get<Mesh>(GetActiveEntity());
+			const Mesh& mesh = std::as_const(scene).Get<Mesh>(GetActiveEntity());
 			const BBox3D world_space_bounds = mesh.bbox.Transformed(transform.worldTransform);
 			additional_translation = world_space_bounds.GetCenter() - transform.GetPositionWorldSpace();
 		}
@@ -169,6 +170,7 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 		{
 			transform.localTransform = world_to_local_transform * world_space_transform;
 			transform.Decompose();
+			scene.MarkDirty<Transform>();
 			m_Changed = true;
 		}
 
@@ -200,7 +202,7 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
 			if (scene.Has<Mesh>(picked))
 			{
-				ImGui::Text(std::string(std::string("Apply to ") + scene.Get<Name>(picked).name).c_str());
+				ImGui::Text(std::string(std::string("Apply to ") + std::as_const(scene).Get<Name>(picked).name).c_str());
 				SetActiveEntity(picked);
 			}
 			else
@@ -223,10 +225,14 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 			{
 				m_Changed = true;
 				mesh->material = entity;
+				scene.MarkDirty<Mesh>();
 			}
 
 			if (scene.Has<Animation>(entity) && skeleton)
+			{
 				skeleton->animation = entity;
+				scene.MarkDirty<Skeleton>();
+			}
 				
 
 			SetActiveEntity(picked);
@@ -237,17 +243,17 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
 	if (show_debug_icons) 
 	{
-		for (const auto& [entity, light] : scene.Each<Light>())
+		for (const auto& [entity, light] : std::as_const(scene).Each<Light>())
 		{
 			AddClickableQuad(viewport, entity, (ImTextureID)GetRenderInterface().GetLightTexture(), light.position, 0.1f);
 		}
 
-		for (const auto& [entity, camera] : scene.Each<Camera>())
+		for (const auto& [entity, camera] : std::as_const(scene).Each<Camera>())
 		{
 			AddClickableQuad(viewport, entity, (ImTextureID)GetRenderInterface().GetCameraTexture(), camera.GetPosition(), 0.1f);
 		}
 
-		for (const auto& [entity, light, transform] : scene.Each<DirectionalLight, Transform>())
+		for (const auto& [entity, light, transform] : std::as_const(scene).Each<DirectionalLight, Transform>())
 		{
 			AddClickableQuad(viewport, entity, (ImTextureID)GetRenderInterface().GetLightTexture(), transform.position, 0.1f);
 		}
@@ -410,7 +416,6 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
 			GetPhysics().GenerateRigidBodiesEntireScene(GetScene());
 
-			g_ThreadPool.WaitForJobs();
 			m_Editor->LogMessage("Rigid Body Generation took " + timer.GetElapsedFormatted() + " seconds.");
 		}
 
@@ -475,7 +480,7 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 
 		if (GetScene().Has<Name, Camera>(camera_entity))
 		{
-			camera_name = GetScene().Get<Name>(camera_entity).name.c_str();
+			camera_name = std::as_const(GetScene()).Get<Name>(camera_entity).name.c_str();
 		}
 
 		if (ImGui::BeginCombo("##ActiveCamera", camera_name)) 
@@ -483,9 +488,9 @@ void ViewportWidget::Draw(Widgets* inWidgets, float inDeltaTime)
 			if (ImGui::Selectable("<built-in>", camera_entity == Entity::Null))
 				m_Editor->SetCameraEntity(Entity::Null);
 
-			for (const auto& [entity, camera] : GetScene().Each<Camera>())
+			for (const auto& [entity, camera] : std::as_const(GetScene()).Each<Camera>())
 			{
-				const Name& name = GetScene().Get<Name>(entity);
+				const Name& name = std::as_const(GetScene()).Get<Name>(entity);
 
 				if (ImGui::Selectable(name.name.c_str(), camera_entity == entity))
 					m_Editor->SetCameraEntity(entity);
@@ -2,8 +2,10 @@
 #include "App.h"
 #include "Launcher.h"
 #include "Compiler.h"
+#include "AssetCompiler.h"
 #include "Engine/OS.h"
 #include "Engine/ecs.h"
+#include "Engine/Components.h"
 #include "Engine/timer.h"
 
 using namespace RK;
@@ -12,6 +14,19 @@ int main(int argc, char** argv)
 {
     g_CVariables = new CVariables(argc, argv);
 
+    // Headless asset compiler for CI, e.g. Editor -compile_assets=assets, no window and the exit code reports failures
+    if (OS::sCheckCommandLineOption("-compile_assets"))
+    {
+        gRegisterPrimitiveTypes();
+        gRegisterComponentTypes();
+
+        const String directory = OS::sGetCommandLineValue("-compile_assets");
+        const int exit_code = gRunHeadlessAssetCompiler(directory.empty() ? "assets" : directory, OS::sCheckCommandLineOption("-compile_scripts"));
+
+        delete g_CVariables;
+        return exit_code;
+    }
+
     bool should_launch = true;
     bool is_asset_compiler = OS::sCheckCommandLineOption("-asset_compiler");
 
@@ -19,6 +19,7 @@ RTTI_DEFINE_TYPE(QuatKey)
 }
 
 
+// keep in sync with RTTI_DECLARE_SERIALIZER in KeyFrames
 RTTI_DEFINE_TYPE(KeyFrames)
 {
 	RTTI_DEFINE_MEMBER(KeyFrames, SERIALIZE_ALL, "Scale Keys", m_ScaleKeys);
@@ -27,6 +28,7 @@ RTTI_DEFINE_TYPE(KeyFrames)
 }
 
 
+// keep in sync with RTTI_DECLARE_SERIALIZER in Animation
 RTTI_DEFINE_TYPE(Animation)
 {
 	RTTI_DEFINE_MEMBER(Animation, SERIALIZE_ALL, "Name", m_Name);
@@ -63,6 +63,8 @@ private:
 	Array<Vec3Key> m_ScaleKeys;
 	Array<Vec3Key> m_PositionKeys;
 	Array<QuatKey> m_RotationKeys;
+
+	RTTI_DECLARE_SERIALIZER(&KeyFrames::m_ScaleKeys, &KeyFrames::m_PositionKeys, &KeyFrames::m_RotationKeys);
 };
 
 class Animation
@@ -124,6 +126,8 @@ private:
 	float m_TotalDuration = 0.0f;
 	/* Arrays of keyframes mapped to bone/joint indices. */
 	HashMap<String, KeyFrames> m_KeyFrames;
+
+	RTTI_DECLARE_SERIALIZER(&Animation::m_Name, &Animation::m_TotalDuration, &Animation::m_KeyFrames);
 };
 
 } // raekor
@@ -41,6 +41,17 @@ Application::Application(WindowFlags inFlags)
 	if (OS::sCheckCommandLineOption("-run_tests"))
 	{
 		RunArchiveTests();
+		RunHashTests();
+		RunSceneSaveTests();
+	}
+
+	if (OS::sCheckCommandLineOption("-run_benchmarks"))
+	{
+		RunMathsBenchmark();
+		RunComponentSerializationBenchmark();
+		JSON::RunJSONBenchmark();
+		RunAssetsBenchmark();
+		RunTextureCompressionBenchmark();
 	}
 
 	RunECStorageTests();
@@ -171,6 +182,9 @@ void Application::Run()
 
 		OnUpdate(dt);
 
+		if (Assets* assets = GetAssets())
+			assets->EvictAsync();
+
 		m_DiscordRPC.OnUpdate();
 
 		dt = timer.Restart();
@@ -352,19 +366,27 @@ void IRenderInterface::UploadMaterialTextures(Entity inEntity, Material& inMater
 {
 	assert(Material::Default.IsLoaded() && "Default material not loaded, did the programmer forget to initialize its gpu maps before opening a scene?");
 
-	auto UploadTexture = [&](const String& inFile, bool inIsSRGB, uint8_t inSwizzle, uint32_t inDefaultMap, uint32_t& ioGpuMap)
+	auto UploadTexture = [&](const String& inFile, bool inIsSRGB, uint8_t inSwizzle, uint32_t inDefaultMap, uint32_t& ioGpuMap, TextureAsset::Ptr& outAsset)
 	{
-		if (TextureAsset::Ptr asset = inAssets.GetAsset<TextureAsset>(inFile))
-			ioGpuMap = UploadTextureFromAsset(asset, inIsSRGB, inSwizzle);
+		// the material holds on to the asset so it's pinned in the registry for as long as the texture is in use
+		outAsset = inAssets.GetAsset<TextureAsset>(inFile);
+
+		if (outAsset)
+		{
+			ioGpuMap = UploadTextureFromAsset(outAsset, inIsSRGB, inSwizzle);
+
+			// the texture lives on the GPU now, keeping the asset pinned shouldn't keep its (possibly decompressed) data around too
+			inAssets.ReleaseData(outAsset);
+		}
 		else
 			ioGpuMap = inDefaultMap;
 	};
 
-	UploadTexture(inMaterial.albedoFile, true, inMaterial.gpuAlbedoMapSwizzle, Material::Default.gpuAlbedoMap, inMaterial.gpuAlbedoMap);
-	UploadTexture(inMaterial.normalFile, false, inMaterial.gpuNormalMapSwizzle, Material::Default.gpuNormalMap, inMaterial.gpuNormalMap);
-	UploadTexture(inMaterial.emissiveFile, false, inMaterial.gpuEmissiveMapSwizzle, Material::Default.gpuEmissiveMap, inMaterial.gpuEmissiveMap);
-	UploadTexture(inMaterial.metallicFile, false, inMaterial.gpuMetallicMapSwizzle, Material::Default.gpuMetallicMap, inMaterial.gpuMetallicMap);
-	UploadTexture(inMaterial.roughnessFile, false, inMaterial.gpuRoughnessMapSwizzle, Material::Default.gpuRoughnessMap, inMaterial.gpuRoughnessMap);
+	UploadTexture(inMaterial.albedoFile, true, inMaterial.gpuAlbedoMapSwizzle, Material::Default.gpuAlbedoMap, inMaterial.gpuAlbedoMap, inMaterial.albedoAsset);
+	UploadTexture(inMaterial.normalFile, false, inMaterial.gpuNormalMapSwizzle, Material::Default.gpuNormalMap, inMaterial.gpuNormalMap, inMaterial.normalAsset);
+	UploadTexture(inMaterial.emissiveFile, false, inMaterial.gpuEmissiveMapSwizzle, Material::Default.gpuEmissiveMap, inMaterial.gpuEmissiveMap, inMaterial.emissiveAsset);
+	UploadTexture(inMaterial.metallicFile, false, inMaterial.gpuMetallicMapSwizzle, Material::Default.gpuMetallicMap, inMaterial.gpuMetallicMap, inMaterial.metallicAsset);
+	UploadTexture(inMaterial.roughnessFile, false, inMaterial.gpuRoughnessMapSwizzle, Material::Default.gpuRoughnessMap, inMaterial.gpuRoughnessMap, inMaterial.roughnessAsset);
 }
 
 } // namespace Raekor  
\ No newline at end of file
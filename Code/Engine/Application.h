@@ -225,7 +225,9 @@ public:
 	virtual void UploadMaterialTextures(Entity inEntity, Material& inMaterial, Assets& inAssets);
 	virtual void DestroyMaterialTextures(Entity inEntity, Material& inMaterial, Assets& inAssets) = 0;
 
-	virtual uint32_t UploadTextureFromAsset(TextureAsset::Ptr inAsset, bool inIsSRGB = false, uint8_t inSwizzle = TEXTURE_SWIZZLE_RGBA) = 0;
+	/* inMostDetailedMip skips the largest mips, for low resolution previews or when short on memory.
+		Leaves the asset's CPU data alone, callers that are done with it release it through Assets::ReleaseData. */
+	virtual uint32_t UploadTextureFromAsset(TextureAsset::Ptr inAsset, bool inIsSRGB = false, uint8_t inSwizzle = TEXTURE_SWIZZLE_RGBA, uint32_t inMostDetailedMip = 0) = 0;
 
 	virtual void OnResize(const Viewport& inViewport) = 0;
 	virtual void DrawDebugSettings(Application* inApp, Scene& inScene, const Viewport& inViewport) = 0;
@@ -4,6 +4,9 @@
 #include "OS.h"
 #include "rtti.h"
 #include "member.h"
+#include "iter.h"
+#include "Hash.h"
+#include "Components.h"
 
 namespace RK {
 
@@ -24,11 +27,14 @@ void* JSON::ReadArchive::ReadNextObject(RTTI** rtti)
 
     // token index is on the type key
     assert(m_JSON.GetToken(m_TokenIndex).type == JSMN_STRING);  
-    const String& type_name = m_JSON.GetString(m_TokenIndex);
+    const StringView type_name = m_JSON.GetString(m_TokenIndex);
 
     // look up the RTTI and allocate an instance from it
-    *rtti = g_RTTIFactory.GetRTTI(type_name.c_str());
-    void* object = g_RTTIFactory.Construct(type_name.c_str());
+    *rtti = g_RTTIFactory.GetRTTI(gHash32Bit(type_name));
+    if (*rtti == nullptr)
+        return nullptr;
+
+    void* object = (*rtti)->Construct();
 
     // increment from type key to object, get the token
     const jsmntok_t& object_token = m_JSON.GetToken(++m_TokenIndex);
@@ -37,10 +43,10 @@ void* JSON::ReadArchive::ReadNextObject(RTTI** rtti)
 
     for (int key_index = 0; key_index < object_token.size; key_index++)
     {
-        const String& key_string = m_JSON.GetString(m_TokenIndex); // member name
+        const StringView key_string = m_JSON.GetString(m_TokenIndex); // member name
 
         m_TokenIndex++; // increment index to value
-        if (Member* member = (*rtti)->GetMember(key_string.c_str()))
+        if (Member* member = (*rtti)->GetMember(key_string))
         {
             // parse the current value, increment the token index by how many we have parsed
             m_TokenIndex = member->FromJSON(m_JSON, m_TokenIndex, object);
@@ -81,45 +87,325 @@ void JSON::WriteArchive::WriteNextObject(const RTTI& inRTTI, void* inObject)
     
     m_Writer.Write("\n").PopIndent().IndentAndWrite("}");
 
-    m_Ofs << m_Writer.GetString();
-
     m_Objects++;
 
+    if (m_Writer.GetSize() >= sFlushSize)
+        Flush();
+}
+
+
+void JSON::WriteArchive::Flush()
+{
+    const StringView data = m_Writer.GetView();
+    m_Ofs.write(data.data(), data.size());
+
     m_Writer.Clear();
 }
 
 
-void BinaryReadArchive::ReadObject(void** inObject)
+BinaryReadArchive::BinaryReadArchive(const Path& inPath)
 {
-    std::string type_name;
-    ReadFileBinary(m_File, type_name);
+    std::ifstream file(inPath, std::ios::binary);
 
-    *inObject = g_RTTIFactory.Construct(type_name.c_str());
+    if (!file.is_open())
+        return;
+
+    std::error_code error_code;
+    Array<uint8_t> data(fs::file_size(inPath, error_code));
+    file.read((char*)data.data(), data.size());
+
+    m_Buffer = ByteBuffer(std::move(data));
+}
 
-    if (RTTI* rtti = g_RTTIFactory.GetRTTI(type_name.c_str()))
+
+void BinaryReadArchive::ReadObject(void** inObject)
+{
+    if (m_LegacyTypeNames)
     {
+        RTTI* rtti = ReadType();
+        if (!rtti)
+            return;
+
+        *inObject = rtti->Construct();
+
         for (const auto& member : *rtti)
         {
             if (member->GetSerializeType() & SERIALIZE_BINARY)
-                member->FromBinary(m_File, inObject);
+                member->FromBinary(m_Buffer, *inObject);
+        }
+
+        return;
+    }
+
+    const ArchiveType* type = ReadTypeEntry();
+    if (!type)
+        return;
+
+    *inObject = type->rtti ? type->rtti->Construct() : nullptr;
+
+    ReadObject(*type, *inObject);
+}
+
+
+void BinaryReadArchive::ReadObject(const ArchiveType& inType, void* inObject)
+{
+    if (!inType.isReadable)
+    {
+        // we can't find the start of the next object, nothing after this can be trusted
+        m_Buffer.Skip(SIZE_MAX);
+        return;
+    }
+
+    for (const auto& [index, stored_member] : gEnumerate(inType.members))
+    {
+        Member* member = inObject ? inType.plan[index] : nullptr;
+
+        if (stored_member.layout.kind == BinaryLayout::VARIABLE && inType.sizedVariableMembers)
+        {
+            uint64_t size = 0;
+            ReadFileData(m_Buffer, size);
+
+            const uint64_t start = m_Buffer.Tell();
+
+            if (member)
+                member->FromBinary(m_Buffer, inObject);
+
+            // end up right after the member whether it was read or not
+            m_Buffer.Seek(start);
+            m_Buffer.Skip(size);
+        }
+        else if (member)
+            member->FromBinary(m_Buffer, inObject);
+        else if (!gSkipBinary(m_Buffer, stored_member.layout))
+            m_Buffer.Skip(SIZE_MAX);
+    }
+}
+
+
+RTTI* BinaryReadArchive::ReadType()
+{
+    if (m_LegacyTypeNames)
+    {
+        String type_name;
+        ReadFileBinary(m_Buffer, type_name);
+        return g_RTTIFactory.GetRTTI(type_name.c_str());
+    }
+
+    const ArchiveType* type = ReadTypeEntry();
+    return type ? type->rtti : nullptr;
+}
+
+
+const ArchiveType* BinaryReadArchive::ReadTypeEntry()
+{
+    uint32_t index = 0;
+    ReadFileBinary(m_Buffer, index);
+
+    if (index < m_Types.size())
+        return &m_Types[index];
+
+    // anything but the next index means we're reading garbage
+    if (index != m_Types.size())
+        return nullptr;
+
+    uint32_t type_hash = 0;
+    ReadFileBinary(m_Buffer, type_hash);
+
+    ArchiveType& type = m_Types.emplace_back();
+    type.rtti = g_RTTIFactory.GetRTTI(type_hash);
+
+    if (m_LegacyTypeSchema)
+    {
+        // only names were stored, assume members that still exist kept their layout
+        Array<uint32_t> name_hashes;
+        ReadFileBinary(m_Buffer, name_hashes);
+
+        for (uint32_t name_hash : name_hashes)
+        {
+            Member* member = type.rtti ? type.rtti->GetMemberByHash(name_hash) : nullptr;
+            type.members.push_back(ArchiveMember { name_hash, member ? member->GetBinaryLayout() : BinaryLayout() });
         }
     }
+    else if (m_LegacyNestedSchema)
+    {
+        // same as above for the nested schema, members that kept their kind and size are assumed to hold the same nested type
+        struct LegacyArchiveMember
+        {
+            uint32_t nameHash;
+            BinaryLayout::EKind kind;
+            uint32_t size;
+        };
+
+        Array<LegacyArchiveMember> legacy_members;
+        ReadFileBinary(m_Buffer, legacy_members);
+
+        for (const LegacyArchiveMember& legacy_member : legacy_members)
+        {
+            BinaryLayout layout = { legacy_member.kind, legacy_member.size };
 
+            if (Member* member = type.rtti ? type.rtti->GetMemberByHash(legacy_member.nameHash) : nullptr)
+            {
+                const BinaryLayout current_layout = member->GetBinaryLayout();
+
+                if (current_layout.kind == layout.kind && current_layout.size == layout.size)
+                    layout.schema = current_layout.schema;
+            }
+
+            type.members.push_back(ArchiveMember { legacy_member.nameHash, layout });
+        }
+    }
+    else
+    {
+        ReadFileBinary(m_Buffer, type.members);
+    }
+
+    type.sizedVariableMembers = !m_LegacyVariableMembers;
+    type.CompilePlan();
+
+    if (type.rtti && !type.matchesRTTI)
+        std::cout << std::format("[Archive] Member layout of {} changed, {}.\n", type.rtti->GetTypeName(), type.isReadable ? "remapping members" : "data can not be recovered");
+
+    return &type;
+}
+
+
+void ArchiveType::CompilePlan()
+{
+    plan.resize(members.size());
+    matchesRTTI = rtti != nullptr;
+    isReadable = true;
+
+    uint32_t member_index = 0;
+
+    if (rtti)
+    {
+        for (const auto& member : *rtti)
+        {
+            if (( member->GetSerializeType() & SERIALIZE_BINARY ) == 0)
+                continue;
+
+            if (member_index >= members.size() || members[member_index].nameHash != member->GetNameHash() || members[member_index].layout != member->GetBinaryLayout())
+                matchesRTTI = false;
+
+            member_index++;
+        }
+    }
+
+    if (member_index != members.size())
+        matchesRTTI = false;
+
+    for (const auto& [index, stored_member] : gEnumerate(members))
+    {
+        Member* member = rtti ? rtti->GetMemberByHash(stored_member.nameHash) : nullptr;
+
+        // removed, no longer binary or stored differently, skip it and leave the new member default initialized
+        if (member && ( ( member->GetSerializeType() & SERIALIZE_BINARY ) == 0 || member->GetBinaryLayout() != stored_member.layout ))
+            member = nullptr;
+
+        plan[index] = member;
+
+        if (stored_member.layout.kind == BinaryLayout::VARIABLE)
+        {
+            hasVariableMembers = true;
+
+            if (!member && !sizedVariableMembers)
+                isReadable = false;
+        }
+    }
 }
 
 
 void BinaryWriteArchive::WriteObject(const RTTI& inRTTI, void* inObject)
 {
-    WriteFileBinary(m_File, std::string(inRTTI.GetTypeName()));
+    WriteType(inRTTI);
+    WriteMembers(inRTTI, inObject);
+}
+
+
+void BinaryWriteArchive::WriteMembers(const RTTI& inRTTI, const void* inObject)
+{
+    const Array<ArchiveMember>& members = m_TypeMembers[m_LastTypeIndex];
+    size_t index = 0;
 
     for (const auto& member : inRTTI)
     {
-        if (member->GetSerializeType() & SERIALIZE_BINARY)
-        member->ToBinary(m_File, inObject);
+        if (( member->GetSerializeType() & SERIALIZE_BINARY ) == 0)
+            continue;
+
+        if (members[index++].layout.kind == BinaryLayout::VARIABLE)
+            gWriteSizePrefixed(m_Buffer, [&]() { member->ToBinary(m_Buffer, inObject); });
+        else
+            member->ToBinary(m_Buffer, inObject);
     }
 }
 
 
+bool BinaryWriteArchive::Flush()
+{
+    if (m_Path.empty())
+        return true;
+
+    const Path path = std::exchange(m_Path, Path());
+    const uint64_t offset = m_Buffer.GetOffset();
+    const Array<uint8_t>& data = m_Buffer.GetData();
+
+    // writing at an offset needs std::ios::in, or the file gets truncated on open
+    std::fstream file(path, offset ? std::ios::binary | std::ios::in | std::ios::out : std::ios::binary | std::ios::out);
+
+    if (!file.is_open())
+        return false;
+
+    file.seekp(offset);
+    file.write((const char*)data.data(), data.size());
+    file.close();
+
+    if (offset)
+    {
+        std::error_code error_code;
+        fs::resize_file(path, offset + data.size(), error_code);
+    }
+
+    return !file.fail();
+}
+
+
+void BinaryWriteArchive::WriteType(const RTTI& inRTTI)
+{
+    // component tables write the same type over and over
+    if (inRTTI.GetHash() == m_LastTypeHash)
+    {
+        WriteFileBinary(m_Buffer, m_LastTypeIndex);
+        return;
+    }
+
+    const auto [iter, inserted] = m_TypeIndices.try_emplace(inRTTI.GetHash(), uint32_t(m_TypeIndices.size()));
+
+    m_LastTypeHash = inRTTI.GetHash();
+    m_LastTypeIndex = iter->second;
+
+    WriteFileBinary(m_Buffer, iter->second);
+
+    if (inserted)
+    {
+        // first time we see this type, write its table entry
+        Array<ArchiveMember>& members = m_TypeMembers.emplace_back();
+        members.reserve(inRTTI.GetMemberCount());
+
+        for (const auto& member : inRTTI)
+        {
+            if (member->GetSerializeType() & SERIALIZE_BINARY)
+                members.push_back(ArchiveMember { member->GetNameHash(), member->GetBinaryLayout() });
+        }
+
+        WriteFileBinary(m_Buffer, inRTTI.GetHash());
+        WriteFileBinary(m_Buffer, members);
+    }
+
+    const Array<ArchiveMember>& members = m_TypeMembers[m_LastTypeIndex];
+    m_LastTypeHasVariableMembers = std::any_of(members.begin(), members.end(), [](const ArchiveMember& inMember) { return inMember.layout.kind == BinaryLayout::VARIABLE; });
+}
+
+
 struct TestStrings
 {
     RTTI_DECLARE_TYPE(TestStrings);
@@ -138,6 +424,233 @@ struct Test
     std::unordered_map<uint32_t, TestStrings> VectorMap;
 };
 
+struct TestPacked
+{
+    RTTI_DECLARE_TYPE(TestPacked);
+
+    uint32_t Integer = 0;
+    float Float = 0.0f;
+    Vec3 Vector = Vec3(0.0f);
+};
+
+struct TestPadded
+{
+    RTTI_DECLARE_TYPE(TestPadded);
+
+    uint32_t Integer = 0;
+    double Double = 0.0;
+};
+
+// trivially copyable and tightly packed, but the second member is JSON only
+struct TestPartial
+{
+    RTTI_DECLARE_TYPE(TestPartial);
+
+    uint32_t Integer = 0;
+    uint32_t Transient = 0;
+};
+
+struct TestNested
+{
+    RTTI_DECLARE_TYPE(TestNested);
+
+    uint32_t Integer = 0;
+    TestPacked Packed;
+    TestPartial Partial;
+};
+
+struct TestSerialized
+{
+    RTTI_DECLARE_TYPE(TestSerialized);
+
+    uint32_t Integer = 0;
+    float Transient = 0.0f; // JSON only, not part of the serializer
+    TestPadded Padded;
+    std::vector<std::string> Strings;
+
+    RTTI_DECLARE_SERIALIZER(&TestSerialized::Integer, &TestSerialized::Padded, &TestSerialized::Strings);
+};
+
+// the same type before and after a few engine changes
+struct TestSchemaV1
+{
+    RTTI_DECLARE_TYPE(TestSchemaV1);
+
+    uint32_t Integer = 0;
+    std::string Removed;
+    float Kept = 0.0f;
+    uint32_t Changed = 0;
+    std::vector<uint32_t> Indices;
+};
+
+struct TestSchemaV2
+{
+    RTTI_DECLARE_TYPE(TestSchemaV2);
+
+    float Kept = 0.0f;
+    std::vector<uint32_t> Indices;
+    uint32_t Integer = 0;
+    uint64_t Changed = 42;
+    double Added = 2.0;
+};
+
+// nested types that change between versions while the members holding them keep their layout
+struct TestPodV1
+{
+    RTTI_DECLARE_TYPE(TestPodV1);
+
+    uint32_t A = 0;
+    uint32_t B = 0;
+};
+
+struct TestPodV2
+{
+    RTTI_DECLARE_TYPE(TestPodV2);
+
+    uint32_t B = 0;
+    uint32_t A = 0;
+};
+
+struct TestInnerV1
+{
+    RTTI_DECLARE_TYPE(TestInnerV1);
+
+    uint32_t Value = 0;
+    std::string Name;
+};
+
+struct TestInnerV2
+{
+    RTTI_DECLARE_TYPE(TestInnerV2);
+
+    uint64_t Value = 0;
+    std::string Name;
+};
+
+struct TestOuterV1
+{
+    RTTI_DECLARE_TYPE(TestOuterV1);
+
+    uint32_t Integer = 0;
+    std::vector<TestPodV1> Pods;
+    TestInnerV1 Inner;
+};
+
+struct TestOuterV2
+{
+    RTTI_DECLARE_TYPE(TestOuterV2);
+
+    uint32_t Integer = 0;
+    std::vector<TestPodV2> Pods;
+    TestInnerV1 Inner;
+};
+
+struct TestOuterV3
+{
+    RTTI_DECLARE_TYPE(TestOuterV3);
+
+    uint32_t Integer = 0;
+    std::vector<TestPodV1> Pods;
+    TestInnerV2 Inner;
+};
+
+RTTI_DEFINE_TYPE(TestPodV1)
+{
+    RTTI_DEFINE_MEMBER(TestPodV1, SERIALIZE_ALL, "A", A);
+    RTTI_DEFINE_MEMBER(TestPodV1, SERIALIZE_ALL, "B", B);
+}
+
+RTTI_DEFINE_TYPE(TestPodV2)
+{
+    RTTI_DEFINE_MEMBER(TestPodV2, SERIALIZE_ALL, "B", B);
+    RTTI_DEFINE_MEMBER(TestPodV2, SERIALIZE_ALL, "A", A);
+}
+
+RTTI_DEFINE_TYPE(TestInnerV1)
+{
+    RTTI_DEFINE_MEMBER(TestInnerV1, SERIALIZE_ALL, "Value", Value);
+    RTTI_DEFINE_MEMBER(TestInnerV1, SERIALIZE_ALL, "Name", Name);
+}
+
+RTTI_DEFINE_TYPE(TestInnerV2)
+{
+    RTTI_DEFINE_MEMBER(TestInnerV2, SERIALIZE_ALL, "Value", Value);
+    RTTI_DEFINE_MEMBER(TestInnerV2, SERIALIZE_ALL, "Name", Name);
+}
+
+RTTI_DEFINE_TYPE(TestOuterV1)
+{
+    RTTI_DEFINE_MEMBER(TestOuterV1, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestOuterV1, SERIALIZE_ALL, "Pods", Pods);
+    RTTI_DEFINE_MEMBER(TestOuterV1, SERIALIZE_ALL, "Inner", Inner);
+}
+
+RTTI_DEFINE_TYPE(TestOuterV2)
+{
+    RTTI_DEFINE_MEMBER(TestOuterV2, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestOuterV2, SERIALIZE_ALL, "Pods", Pods);
+    RTTI_DEFINE_MEMBER(TestOuterV2, SERIALIZE_ALL, "Inner", Inner);
+}
+
+RTTI_DEFINE_TYPE(TestOuterV3)
+{
+    RTTI_DEFINE_MEMBER(TestOuterV3, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestOuterV3, SERIALIZE_ALL, "Pods", Pods);
+    RTTI_DEFINE_MEMBER(TestOuterV3, SERIALIZE_ALL, "Inner", Inner);
+}
+
+RTTI_DEFINE_TYPE(TestPacked)
+{
+    RTTI_DEFINE_MEMBER(TestPacked, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestPacked, SERIALIZE_ALL, "Float", Float);
+    RTTI_DEFINE_MEMBER(TestPacked, SERIALIZE_ALL, "Vector", Vector);
+}
+
+RTTI_DEFINE_TYPE(TestPadded)
+{
+    RTTI_DEFINE_MEMBER(TestPadded, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestPadded, SERIALIZE_ALL, "Double", Double);
+}
+
+RTTI_DEFINE_TYPE(TestPartial)
+{
+    RTTI_DEFINE_MEMBER(TestPartial, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestPartial, SERIALIZE_JSON, "Transient", Transient);
+}
+
+RTTI_DEFINE_TYPE(TestNested)
+{
+    RTTI_DEFINE_MEMBER(TestNested, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestNested, SERIALIZE_ALL, "Packed", Packed);
+    RTTI_DEFINE_MEMBER(TestNested, SERIALIZE_ALL, "Partial", Partial);
+}
+
+RTTI_DEFINE_TYPE(TestSerialized)
+{
+    RTTI_DEFINE_MEMBER(TestSerialized, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestSerialized, SERIALIZE_JSON, "Transient", Transient);
+    RTTI_DEFINE_MEMBER(TestSerialized, SERIALIZE_ALL, "Padded", Padded);
+    RTTI_DEFINE_MEMBER(TestSerialized, SERIALIZE_ALL, "Strings", Strings);
+}
+
+RTTI_DEFINE_TYPE(TestSchemaV1)
+{
+    RTTI_DEFINE_MEMBER(TestSchemaV1, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestSchemaV1, SERIALIZE_ALL, "Removed", Removed);
+    RTTI_DEFINE_MEMBER(TestSchemaV1, SERIALIZE_ALL, "Kept", Kept);
+    RTTI_DEFINE_MEMBER(TestSchemaV1, SERIALIZE_ALL, "Changed", Changed);
+    RTTI_DEFINE_MEMBER(TestSchemaV1, SERIALIZE_ALL, "Indices", Indices);
+}
+
+RTTI_DEFINE_TYPE(TestSchemaV2)
+{
+    RTTI_DEFINE_MEMBER(TestSchemaV2, SERIALIZE_ALL, "Kept", Kept);
+    RTTI_DEFINE_MEMBER(TestSchemaV2, SERIALIZE_ALL, "Indices", Indices);
+    RTTI_DEFINE_MEMBER(TestSchemaV2, SERIALIZE_ALL, "Integer", Integer);
+    RTTI_DEFINE_MEMBER(TestSchemaV2, SERIALIZE_ALL, "Changed", Changed);
+    RTTI_DEFINE_MEMBER(TestSchemaV2, SERIALIZE_ALL, "Added", Added);
+}
+
 RTTI_DEFINE_TYPE(TestStrings)
 {
     RTTI_DEFINE_MEMBER(TestStrings, SERIALIZE_ALL, "Strings 0", Strings0);
@@ -157,11 +670,20 @@ void RunArchiveTests()
     g_RTTIFactory.Register(RTTI_OF<Test>());
     g_RTTIFactory.Register(RTTI_OF<TestStrings>());
 
+    {
+        // member and type lookups by name, custom name and precomputed hash all resolve to the same thing
+        const RTTI& rtti = RTTI_OF<Test>();
+        assert(rtti.GetMember("Integer") == rtti.GetMemberByHash(gHash32Bit("Integer")));
+        assert(rtti.GetMember(StringView("Integer")) == rtti.GetMember(0u));
+        assert(rtti.GetMemberIndex("Map") == rtti.GetMemberIndexByHash(gHash32Bit("Map")));
+        assert(rtti.GetMember("DoesNotExist") == nullptr && rtti.GetMemberIndex("DoesNotExist") == -1);
+        assert(g_RTTIFactory.GetRTTI(gHash32Bit("Test")) == &rtti);
+    }
+
     const auto TEMP_FILE = OS::sGetTempPath() / "test.bin";
 
+    const auto CreateTest = []()
     {
-        BinaryWriteArchive archive(TEMP_FILE);
-
         Test test;
         test.Integer = -1;
         test.String = "Hello World";
@@ -174,7 +696,43 @@ void RunArchiveTests()
         test.VectorMap[12].Strings1.push_back("str2");
         test.VectorMap[12].Strings1.push_back("str3");
 
+        return test;
+    };
+
+    {
+        BinaryWriteArchive archive(TEMP_FILE);
+
+        Test test = CreateTest();
         archive << test;
+
+        // only the first object of a type carries its type table entry
+        const uint64_t start = archive.GetBuffer().Tell();
+        archive << test;
+        assert(archive.GetBuffer().Tell() - start < start);
+
+        // after a reset the entry is written again
+        archive.ResetTypeTable();
+        archive << test;
+    }
+
+    // a memory only archive should produce the exact same bytes as what ended up on disk
+    {
+        BinaryReadArchive file_archive(TEMP_FILE);
+        BinaryWriteArchive memory_archive;
+
+        Test test = CreateTest();
+        memory_archive << test << test;
+        memory_archive.ResetTypeTable();
+        memory_archive << test;
+
+        assert(memory_archive.GetBuffer().GetData() == file_archive.GetBuffer().GetData());
+
+        // and reading it back from memory should give the same object
+        BinaryReadArchive read_archive(ByteBuffer(Array<uint8_t>(memory_archive.GetBuffer().GetData())));
+
+        Test read_test;
+        read_archive >> read_test;
+        assert(read_test.String == test.String && read_test.VectorMap[12].Strings1 == test.VectorMap[12].Strings1);
     }
 
     {
@@ -193,8 +751,289 @@ void RunArchiveTests()
         assert(test.VectorMap[5].Strings0[1] == "str1");
         assert(test.VectorMap[12].Strings1[0] == "str2");
         assert(test.VectorMap[12].Strings1[1] == "str3");
+
+        Test second_test;
+        archive >> second_test;
+        assert(second_test.String == test.String);
+
+        Test third_test;
+        archive.ResetTypeTable();
+        archive >> third_test;
+        assert(third_test.VectorMap[12].Strings1[1] == "str3");
+    }
+
+    // data written by an older version of a type is remapped onto the current members
+    {
+        g_RTTIFactory.Register(RTTI_OF<TestSchemaV1>());
+        g_RTTIFactory.Register(RTTI_OF<TestSchemaV2>());
+
+        TestSchemaV1 old_object = { 7, "gone", 0.5f, 3, { 1, 2, 3 } };
+
+        BinaryWriteArchive write_archive;
+        write_archive << old_object << old_object;
+
+        // pretend V1 was renamed to V2 by patching the type hash of the table entry, it sits right after the first type index
+        Array<uint8_t> data = write_archive.GetBuffer().GetData();
+        const uint32_t new_hash = RTTI_OF<TestSchemaV2>().GetHash();
+        std::memcpy(data.data() + sizeof(uint32_t), &new_hash, sizeof(new_hash));
+
+        BinaryReadArchive read_archive(ByteBuffer(std::move(data)));
+
+        TestSchemaV2 first, second;
+        read_archive >> first >> second;
+
+        for (const TestSchemaV2& object : { first, second })
+        {
+            assert(object.Integer == old_object.Integer && object.Kept == old_object.Kept && object.Indices == old_object.Indices);
+            assert(object.Changed == 42 && object.Added == 2.0); // layout changed or new, default initialized
+        }
+
+        assert(read_archive.IsEOF());
+    }
+
+    // a nested type changing is caught even though the member holding it keeps its layout
+    {
+        g_RTTIFactory.Register(RTTI_OF<TestOuterV1>());
+        g_RTTIFactory.Register(RTTI_OF<TestOuterV2>());
+        g_RTTIFactory.Register(RTTI_OF<TestOuterV3>());
+
+        assert(RTTI_OF<TestOuterV1>().GetMember("Pods")->GetBinaryLayout().kind == RTTI_OF<TestOuterV2>().GetMember("Pods")->GetBinaryLayout().kind);
+        assert(RTTI_OF<TestOuterV1>().GetMember("Pods")->GetBinaryLayout() != RTTI_OF<TestOuterV2>().GetMember("Pods")->GetBinaryLayout());
+        assert(RTTI_OF<TestOuterV1>().GetMember("Inner")->GetBinaryLayout() != RTTI_OF<TestOuterV3>().GetMember("Inner")->GetBinaryLayout());
+
+        TestOuterV1 old_object = { 7, { { 1, 2 }, { 3, 4 } }, { 5, "inner" } };
+
+        BinaryWriteArchive write_archive;
+        write_archive << old_object;
+
+        const auto PatchTypeHash = [&](uint32_t inHash)
+        {
+            Array<uint8_t> data = write_archive.GetBuffer().GetData();
+            std::memcpy(data.data() + sizeof(uint32_t), &inHash, sizeof(inHash));
+            return ByteBuffer(std::move(data));
+        };
+
+        // the pod array is skippable, so it's dropped and the rest is still read
+        {
+            BinaryReadArchive read_archive(PatchTypeHash(RTTI_OF<TestOuterV2>().GetHash()));
+
+            TestOuterV2 object;
+            read_archive >> object;
+
+            assert(object.Integer == old_object.Integer && object.Pods.empty());
+            assert(object.Inner.Value == old_object.Inner.Value && object.Inner.Name == old_object.Inner.Name);
+            assert(read_archive.IsEOF());
+        }
+
+        // the inner type is stored with its size in front, so it's dropped as well
+        {
+            BinaryReadArchive read_archive(PatchTypeHash(RTTI_OF<TestOuterV3>().GetHash()));
+
+            TestOuterV3 object;
+            read_archive >> object;
+
+            assert(object.Integer == old_object.Integer && object.Pods.size() == old_object.Pods.size());
+            assert(object.Inner.Value == 0 && object.Inner.Name.empty());
+            assert(read_archive.IsEOF());
+        }
+
+        // data from before the size prefix can't skip the inner type, so the object is rejected instead of read as garbage
+        {
+            BinaryWriteArchive legacy_archive;
+            legacy_archive.WriteType(RTTI_OF<TestOuterV1>());
+            WriteFileBinary(legacy_archive.GetBuffer(), old_object);
+
+            Array<uint8_t> data = legacy_archive.GetBuffer().GetData();
+            const uint32_t new_hash = RTTI_OF<TestOuterV3>().GetHash();
+            std::memcpy(data.data() + sizeof(uint32_t), &new_hash, sizeof(new_hash));
+
+            BinaryReadArchive read_archive(ByteBuffer(std::move(data)));
+            read_archive.SetLegacyVariableMembers(true);
+
+            TestOuterV3 object;
+            read_archive >> object;
+
+            assert(object.Integer == 0 && object.Pods.empty() && object.Inner.Value == 0);
+            assert(read_archive.IsEOF());
+        }
+
+        // same data read as the type it was written with
+        {
+            BinaryReadArchive read_archive(ByteBuffer(Array<uint8_t>(write_archive.GetBuffer().GetData())));
+
+            TestOuterV1 object;
+            read_archive >> object;
+
+            assert(object.Integer == old_object.Integer && object.Pods.size() == old_object.Pods.size() && object.Inner.Name == old_object.Inner.Name);
+            assert(read_archive.IsEOF());
+        }
+    }
+
+    // tightly packed POD types take the memcpy path, which has to match the per member layout byte for byte
+    {
+        g_RTTIFactory.Register(RTTI_OF<TestPacked>());
+        g_RTTIFactory.Register(RTTI_OF<TestPadded>());
+
+        assert(RTTI_OF<TestPacked>().IsTriviallySerializable());
+        assert(!RTTI_OF<TestPadded>().IsTriviallySerializable());
+        assert(!RTTI_OF<Test>().IsTriviallySerializable());
+
+        TestPacked packed = { 7, 0.5f, Vec3(1.0f, 2.0f, 3.0f) };
+        TestPadded padded = { 9, 0.25 };
+
+        ByteBuffer memberwise;
+        for (const auto& member : RTTI_OF<TestPacked>())
+            member->ToBinary(memberwise, &packed);
+
+        ByteBuffer memcpy_buffer;
+        WriteFileBinary(memcpy_buffer, packed);
+        assert(memberwise.GetData() == memcpy_buffer.GetData());
+
+        BinaryWriteArchive write_archive;
+        write_archive << packed << padded;
+
+        BinaryReadArchive read_archive(ByteBuffer(Array<uint8_t>(write_archive.GetBuffer().GetData())));
+
+        TestPacked read_packed;
+        TestPadded read_padded;
+        read_archive >> read_packed >> read_padded;
+
+        assert(read_packed.Integer == packed.Integer && read_packed.Float == packed.Float && read_packed.Vector == packed.Vector);
+        assert(read_padded.Integer == padded.Integer && read_padded.Double == padded.Double);
+    }
+
+    // nested RTTI members only take the memcpy path if the nested type would too
+    {
+        g_RTTIFactory.Register(RTTI_OF<TestPartial>());
+        g_RTTIFactory.Register(RTTI_OF<TestNested>());
+
+        assert(!RTTI_OF<TestPartial>().IsTriviallySerializable());
+        assert(!RTTI_OF<TestNested>().IsTriviallySerializable());
+
+        TestNested nested = { 1, { 7, 0.5f, Vec3(1.0f) }, { 2, 3 } };
+
+        ByteBuffer memberwise;
+        WriteFileBinary(memberwise, nested.Integer);
+        WriteFileBinary(memberwise, nested.Packed);
+        WriteFileBinary(memberwise, nested.Partial.Integer);
+
+        ByteBuffer buffer;
+        WriteFileBinary(buffer, nested);
+        assert(memberwise.GetData() == buffer.GetData());
+    }
+
+    {
+        // compile time serializer has to match the reflective path byte for byte
+        g_RTTIFactory.Register(RTTI_OF<TestSerialized>());
+        assert(gSerializerMatchesRTTI<TestSerialized>());
+
+        TestSerialized serialized = { 3, 1.0f, { 5, 0.75 }, { "a", "bc" } };
+
+        ByteBuffer memberwise;
+        for (const auto& member : RTTI_OF<TestSerialized>())
+        {
+            if (member->GetSerializeType() & SERIALIZE_BINARY)
+                member->ToBinary(memberwise, &serialized);
+        }
+
+        ByteBuffer inlined;
+        WriteFileBinary(inlined, serialized);
+        assert(memberwise.GetData() == inlined.GetData());
+
+        BinaryWriteArchive write_archive;
+        write_archive << serialized;
+
+        BinaryReadArchive read_archive(ByteBuffer(Array<uint8_t>(write_archive.GetBuffer().GetData())));
+
+        TestSerialized read_serialized;
+        read_archive >> read_serialized;
+
+        assert(read_serialized.Integer == serialized.Integer && read_serialized.Transient == 0.0f);
+        assert(read_serialized.Padded.Double == serialized.Padded.Double && read_serialized.Strings == serialized.Strings);
+    }
+
+    {
+        // integers outside the target type's range are rejected instead of cast
+        const JSON::JSONData json(String("[-1, 3.0, 5000000000, -7, 1e3]"));
+        assert(json.GetNumber<uint32_t>(1) == 0);
+        assert(json.GetNumber<uint32_t>(2) == 3);
+        assert(json.GetNumber<uint32_t>(3) == 0);
+        assert(json.GetNumber<uint64_t>(3) == 5000000000ull);
+        assert(json.GetNumber<int32_t>(4) == -7);
+        assert(json.GetNumber<uint8_t>(5) == 0);
+        assert(json.GetNumber<uint16_t>(5) == 1000);
+    }
+
+    {
+        // meshlets are built once by the asset compiler, they have to survive a round trip with their bounds intact
+        assert(gSerializerMatchesRTTI<Mesh>());
+
+        Mesh mesh;
+        Mesh::CreateSphere(mesh, 1.0f, 64, 64);
+        mesh.CalculateMeshlets();
+        assert(mesh.meshlets.size() > 1);
+
+        for (const Meshlet& meshlet : mesh.meshlets)
+        {
+            assert(meshlet.mVertexCount <= Mesh::sMeshletMaxVertices && meshlet.mTriangleCount <= Mesh::sMeshletMaxTriangles);
+            assert(glm::length(meshlet.mCenter) <= 1.0f + meshlet.mRadius);
+
+            for (uint32_t triangle : Slice(mesh.meshletTriangles).subspan(meshlet.mTriangleOffset, meshlet.mTriangleCount))
+                assert(( triangle & 0x3FF ) < meshlet.mVertexCount && ( ( triangle >> 10 ) & 0x3FF ) < meshlet.mVertexCount && ( triangle >> 20 ) < meshlet.mVertexCount);
+        }
+
+        BinaryWriteArchive write_archive;
+        write_archive << mesh;
+
+        BinaryReadArchive read_archive(ByteBuffer(Array<uint8_t>(write_archive.GetBuffer().GetData())));
+
+        Mesh read_mesh;
+        read_archive >> read_mesh;
+
+        assert(read_mesh.meshlets.size() == mesh.meshlets.size() && read_mesh.meshletIndices == mesh.meshletIndices && read_mesh.meshletTriangles == mesh.meshletTriangles);
+        assert(read_mesh.meshlets.back().mConeAxis == mesh.meshlets.back().mConeAxis && read_mesh.meshlets.back().mRadius == mesh.meshlets.back().mRadius);
+    }
+
+    {
+        // skipping with sizes that would wrap the position has to clamp to the end instead
+        ByteBuffer buffer(Array<uint8_t>(16));
+        buffer.Skip(4);
+        buffer.Skip(SIZE_MAX);
+        assert(buffer.IsEOF() && buffer.Tell() == 16);
+
+        ByteBuffer corrupt_array;
+        WriteFileData(corrupt_array, size_t(SIZE_MAX / 2));
+        corrupt_array.Seek(0);
+        assert(!gSkipBinary(corrupt_array, BinaryLayout { BinaryLayout::ARRAY, 4 }));
     }
 }
 
+
+void RunHashTests()
+{
+    // reference values from the xxHash spec implementation
+    assert(gHashXXH64("", 0) == 0xef46db3751d8e999);
+    assert(gHashXXH64("a", 1) == 0xd24ec4f1a98c6e5b);
+    assert(gHashXXH64("abc", 3) == 0x44bc2cf5ad770999);
+
+    {
+        // streaming has to match hashing in one go however the input is chunked, including chunks that straddle a 32 byte stripe
+        Array<uint8_t> data(1000);
+        for (size_t index = 0; index < data.size(); index++)
+            data[index] = uint8_t(index * 31 + 7);
+
+        const uint64_t one_shot = gHashXXH64(data.data(), data.size());
+
+        for (size_t chunk_size : { 1, 3, 7, 31, 32, 33, 64, 100, 1000 })
+        {
+            XXHash64 hasher;
+
+            for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+                hasher.Update(data.data() + offset, std::min(chunk_size, data.size() - offset));
+
+            assert(hasher.Digest() == one_shot);
+        }
+    }
 }
 
+}
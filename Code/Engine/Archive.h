@@ -6,74 +6,193 @@
 
 namespace RK {
 
+/*
+	Binary archives write a type table entry (type hash plus the schema of its binary members) the first time a type is seen,
+	every object after that only stores the index into the table. Call ResetTypeTable at the start of anything that is read back on its own.
+	Members with a VARIABLE layout are stored with their size in bytes in front, so any member that was removed or changed can be skipped.
+*/
+struct ArchiveMember
+{
+	uint32_t nameHash = 0;
+	BinaryLayout layout;
+};
+
+
+struct ArchiveType
+{
+	RTTI* rtti = nullptr;
+	Array<ArchiveMember> members; // schema as it was written
+	Array<Member*> plan; // per stored member, the current member to read it into or nullptr to skip it
+	bool matchesRTTI = false; // schema is identical to the current binary members, objects can be read directly
+	bool isReadable = true; // false if a member that's gone or changed can't be skipped
+	bool hasVariableMembers = false; // objects store these with a size prefix, see gWriteSizePrefixed
+	bool sizedVariableMembers = true; // false for data written before VARIABLE members had a size prefix
+
+	/* Maps the stored schema onto the current RTTI, called once per type table entry. */
+	void CompilePlan();
+};
+
+
 class BinaryReadArchive
 {
 public:
-	BinaryReadArchive(const Path& inPath) : m_File(inPath, std::ios::binary | std::ios::in) {}
+	/* Reads the entire file into memory, everything after is a memcpy from the buffer. */
+	BinaryReadArchive(const Path& inPath);
+	BinaryReadArchive(ByteBuffer&& inBuffer) : m_Buffer(std::move(inBuffer)) {}
 
 	template<typename T>
 	BinaryReadArchive& operator>> (T& ioRHS)
 	{
-		String type;
-		ReadFileBinary(m_File, type);
+		if (m_LegacyTypeNames)
+			return ReadLegacyObject(ioRHS);
 
-		if (RTTI* rtti = g_RTTIFactory.GetRTTI(type.c_str()))
-			for (const auto& member : *rtti)
+		const ArchiveType* type = ReadTypeEntry();
+		if (!type)
+			return *this;
+
+		// memcpy or compile time serializer, only valid if the data was written with the exact same members
+		if constexpr (HasRTTI<T>)
+		{
+			if (type->matchesRTTI && type->rtti == &RTTI_OF<T>())
 			{
-				if (member->GetSerializeType() & SERIALIZE_BINARY)
-					member->FromBinary(m_File, &ioRHS);
+				if (!type->hasVariableMembers || !type->sizedVariableMembers)
+				{
+					ReadFileBinary(m_Buffer, ioRHS);
+					return *this;
+				}
+
+				if constexpr (HasSerializer<T>)
+				{
+					std::apply([&](auto... inMembers) { ( ReadMemberBinary(m_Buffer, ioRHS.*inMembers), ... ); }, T::sGetSerializedMembers());
+					return *this;
+				}
 			}
+		}
 
+		if constexpr (HasRTTI<T>)
+			ReadObject(*type, type->rtti == &RTTI_OF<T>() ? &ioRHS : nullptr);
+		else
+			ReadObject(*type, nullptr);
 
 		return *this;
 	}
 
 	void ReadObject(void** inObject);
 
-	bool IsEOF() { return m_File.peek() != EOF; }
+	/* Reads a type table index (and the entry itself the first time), returns nullptr for unknown types. */
+	RTTI* ReadType();
+	void ResetTypeTable() { m_Types.clear(); }
+
+	/* Scene files before version 4 stored the full type name in front of every object. */
+	void SetLegacyTypeNames(bool inEnabled) { m_LegacyTypeNames = inEnabled; }
+	/* Scene files before version 5 only stored member name hashes in the type table. */
+	void SetLegacyTypeSchema(bool inEnabled) { m_LegacyTypeSchema = inEnabled; }
+	/* Scene files before version 6 stored member layouts without the schema hash of nested RTTI types. */
+	void SetLegacyNestedSchema(bool inEnabled) { m_LegacyNestedSchema = inEnabled; }
+	/* Scene files before version 7 stored VARIABLE members without their size, those can't be skipped. */
+	void SetLegacyVariableMembers(bool inEnabled) { m_LegacyVariableMembers = inEnabled; }
 
-	File& GetFile() { return m_File; }
+	bool IsEOF() const { return m_Buffer.IsEOF(); }
+
+	ByteBuffer& GetBuffer() { return m_Buffer; }
 
 private:
-	File m_File;
+	/* Returns nullptr if the index is garbage, entries for unknown types are returned with a null rtti. */
+	const ArchiveType* ReadTypeEntry();
+
+	/* Reads the stored members that still exist into inObject and skips the rest, a null inObject skips the entire object. */
+	void ReadObject(const ArchiveType& inType, void* inObject);
+
+	template<typename T>
+	BinaryReadArchive& ReadLegacyObject(T& ioRHS)
+	{
+		RTTI* rtti = ReadType();
+
+		if constexpr (HasRTTI<T>)
+		{
+			if (rtti == &RTTI_OF<T>())
+			{
+				ReadFileBinary(m_Buffer, ioRHS);
+				return *this;
+			}
+		}
+
+		if (rtti)
+			for (const auto& member : *rtti)
+			{
+				if (member->GetSerializeType() & SERIALIZE_BINARY)
+					member->FromBinary(m_Buffer, &ioRHS);
+			}
+
+		return *this;
+	}
+
+private:
+	ByteBuffer m_Buffer;
+	bool m_LegacyTypeNames = false;
+	bool m_LegacyTypeSchema = false;
+	bool m_LegacyNestedSchema = false;
+	bool m_LegacyVariableMembers = false;
+	Array<ArchiveType> m_Types;
 };
 
 
 class BinaryWriteArchive
 {
 public:
-	BinaryWriteArchive(const Path& inPath) : m_File(inPath, std::ios::binary | std::ios::out) {}
+	/* Memory only, use GetBuffer to get at the data. */
+	BinaryWriteArchive() = default;
+
+	/* Writes go to memory and are flushed to inPath on destruction. A non-zero inOffset keeps the first inOffset bytes of the existing file. */
+	BinaryWriteArchive(const Path& inPath, uint64_t inOffset = 0) : m_Path(inPath), m_Buffer({}, inOffset) {}
+	~BinaryWriteArchive() { Flush(); }
 
 	template<typename T>
 	BinaryWriteArchive& operator<< (const T& ioRHS)
 	{
-		WriteFileBinary(m_File, ioRHS);
+		WriteFileBinary(m_Buffer, ioRHS);
 		return *this;
 	}
 
 	template<typename T> requires HasRTTI<T>
 	BinaryWriteArchive& operator<< (const T& ioRHS)
 	{
-		RTTI& rtti = RTTI_OF<T>();
-		String type = String(rtti.GetTypeName());
+		WriteType(RTTI_OF<T>());
 
-		WriteFileBinary(m_File, type);
-
-		for (const auto& member : rtti)
-		{
-			if (member->GetSerializeType() & SERIALIZE_BINARY)
-				member->ToBinary(m_File, &ioRHS);
-		}
+		// memcpy or compile time serializer, members that need a size prefix go through WriteMemberBinary
+		if (!m_LastTypeHasVariableMembers)
+			WriteFileBinary(m_Buffer, ioRHS);
+		else if constexpr (HasSerializer<T>)
+			std::apply([&](auto... inMembers) { ( WriteMemberBinary(m_Buffer, ioRHS.*inMembers), ... ); }, T::sGetSerializedMembers());
+		else
+			WriteMembers(RTTI_OF<T>(), &ioRHS);
 
 		return *this;
     }
 
 	void WriteObject(const RTTI& inRTTI, void* inObject);
 
-	File& GetFile() { return m_File; }
+	/* Writes the type table index for inRTTI, the first time a type is seen this also writes its table entry. */
+	void WriteType(const RTTI& inRTTI);
+	void ResetTypeTable() { m_TypeIndices.clear(); m_TypeMembers.clear(); m_LastTypeHash = 0; }
+
+	/* Writes the buffer to disk and truncates the file after it, nothing should be written to the archive after this. */
+	bool Flush();
+
+	ByteBuffer& GetBuffer() { return m_Buffer; }
 
 private:
-	File m_File;
+	/* Writes the binary members of the last written type one by one, VARIABLE ones with a size prefix. */
+	void WriteMembers(const RTTI& inRTTI, const void* inObject);
+
+private:
+	Path m_Path;
+	ByteBuffer m_Buffer;
+	uint32_t m_LastTypeHash = 0;
+	uint32_t m_LastTypeIndex = 0;
+	bool m_LastTypeHasVariableMembers = false;
+	HashMap<uint32_t, uint32_t> m_TypeIndices;
+	Array<Array<ArchiveMember>> m_TypeMembers; // schema per type table index
 };
 
 } // namespace raekor
@@ -103,13 +222,14 @@ class WriteArchive
 {
 public:
 	WriteArchive() = default;
-	WriteArchive(const Path& inPath) : m_JSON(inPath, true), m_Ofs(inPath)
+	WriteArchive(const Path& inPath) : m_Ofs(inPath)
 	{
-		m_Ofs << "{\n"; m_Writer.PushIndent();
+		m_Writer.Write("{\n").PushIndent();
 	}
 	~WriteArchive()
 	{
-		m_Ofs << "\n}";
+		m_Writer.Write("\n}");
+		Flush();
 	}
 
 	template<typename T> requires HasRTTI<T>
@@ -119,12 +239,17 @@ public:
 
 	JSONWriter& GetRaw() { return m_Writer; }
 
+	/* Writes everything formatted so far to the file. Happens automatically in large chunks. */
+	void Flush();
+
 private:
+	// objects are formatted into m_Writer and only hit the file once this much has accumulated
+	static constexpr size_t sFlushSize = 4 * 1024 * 1024;
+
 	int m_Objects = 0;;
 	std::ofstream m_Ofs;
 	Array<const char*> m_Types;
 
-	JSONData m_JSON;
 	JSONWriter m_Writer;
 };
 
@@ -148,7 +273,7 @@ ReadArchive& ReadArchive::operator>> (T& ioRHS)
 
 	// token index is on the type key
 	assert(m_JSON.GetToken(m_TokenIndex).type == JSMN_STRING);
-	const String& type_name = m_JSON.GetString(m_TokenIndex);
+	const StringView type_name = m_JSON.GetString(m_TokenIndex);
 
 	const RTTI& rtti = RTTI_OF<T>();
 
@@ -176,7 +301,7 @@ WriteArchive& WriteArchive::operator<< (T& inRHS)
 	}
 
 	if (m_Types.size() > 0)
-		m_Ofs << ",\n";
+		m_Writer.Write(",\n");
 
 	// write the type
 	m_Writer.IndentAndWrite("\"").Write(rtti.GetTypeName()).Write("\":");
@@ -184,11 +309,10 @@ WriteArchive& WriteArchive::operator<< (T& inRHS)
 	// Convert and write the object to write to JSON
 	m_Writer.GetValueToJSON(inRHS);
 
-	m_Ofs << m_Writer.GetString();
-
 	m_Objects++;
 
-	m_Writer.Clear();
+	if (m_Writer.GetSize() >= sFlushSize)
+		Flush();
 
 	m_Types.push_back(rtti.GetTypeName());
 
@@ -197,4 +321,4 @@ WriteArchive& WriteArchive::operator<< (T& inRHS)
 
 } // Raekor::JSON
 
-namespace RK { void RunArchiveTests(); }
\ No newline at end of file
+namespace RK { void RunArchiveTests(); void RunHashTests(); }
\ No newline at end of file
@@ -4,7 +4,9 @@
 #include "Script.h"
 #include "Timer.h"
 #include "Maths.h"
-#include "DDS.h"
+#include "Threading.h"
+#include "CVars.h"
+#include "Iter.h"
 
 namespace RK {
 
@@ -15,7 +17,34 @@ RTTI_DEFINE_TYPE(ScriptAsset) { RTTI_DEFINE_TYPE_INHERITANCE(ScriptAsset, Asset)
 RTTI_DEFINE_TYPE(TextureAsset) { RTTI_DEFINE_TYPE_INHERITANCE(TextureAsset, Asset); }
 
 
-String TextureAsset::Convert(const String& inPath)
+String Asset::GetCachedPath(const String& inAssetPath, const char* inExtension)
+{
+	const Path relative_path = fs::relative(inAssetPath).replace_extension(inExtension);
+
+	Path cached_path = "Cached";
+	bool is_first = true;
+
+	for (const Path& part : relative_path)
+	{
+		String name = part.string();
+		std::transform(name.begin(), name.end(), name.begin(), [](char c) { return char(std::tolower(c)); });
+
+		// drop the leading assets directory, files that live elsewhere keep their path minus any parent directory hops
+		if (( is_first && name == "assets" ) || name == ".." || part.has_root_name() || part.has_root_directory())
+		{
+			is_first = false;
+			continue;
+		}
+
+		is_first = false;
+		cached_path /= part;
+	}
+
+	return cached_path.string();
+}
+
+
+String TextureAsset::Convert(const String& inPath, ETextureUsage inUsage, EMipFilter inFilter)
 {
 	int width = 0, height = 0, ch = 0;
 	stbi_uc* mip0_pixels = stbi_load(inPath.c_str(), &width, &height, &ch, 4);
@@ -26,200 +55,579 @@ String TextureAsset::Convert(const String& inPath)
 		return String();
 	}
 	
-	Array<stbi_uc*> mip_chain;
-	mip_chain.push_back(mip0_pixels);
+	if (inUsage == TEXTURE_USAGE_AUTO)
+		inUsage = gGuessTextureUsage(inPath);
 
-	// if it's not a power of 2, instead of ruling it unusable, try to resize it to a power of 2
-	if (!gIsPow2(width) || !gIsPow2(height))
-	{
-		const size_t aligned_width = gAlignUp(width, 32); 
-		const size_t aligned_height = gAlignUp(height, 32);
+	const Array<MipLevel> mips = gGenerateMipChain(mip0_pixels, width, height, inUsage, inFilter);
+	stbi_image_free(mip0_pixels);
+
+	if (mips[0].width != uint32_t(width) || mips[0].height != uint32_t(height))
+		std::cout << std::format("[Assets] Image {} at {}x{} is not a multiple of 4, resampled to {}x{}.\n", Path(inPath).filename().string(), width, height, mips[0].width, mips[0].height);
+
+	const dds::DXGI_FORMAT format = gSelectTextureFormat(mips[0].pixels.data(), mips[0].width, mips[0].height, inUsage);
 
-		mip_chain.push_back((stbi_uc*)malloc(aligned_width * aligned_height * 4));
-		stbir_resize_uint8_linear(mip_chain[0], width, height, 0, mip_chain[1], aligned_width, aligned_height, 0, STBIR_RGBA);
+	dds::Header header = {};
+	dds::write_header(&header, format, mips[0].width, mips[0].height, uint32_t(mips.size()));
+
+	Array<unsigned char> dds_buffer(header.data_offset() + header.data_size());
+	std::memcpy(dds_buffer.data(), &header, header.data_offset());
 
-		stbi_image_free(mip_chain[0]);
-		mip_chain[0] = mip_chain[1];
-		mip_chain.pop_back();
+	for (const auto& [mip_index, mip] : gEnumerate(mips))
+		gCompressTexture(format, mip.pixels.data(), mip.width, mip.height, dds_buffer.data() + header.mip_offset(uint32_t(mip_index)));
 
-		width = aligned_width;
-		height = aligned_height;
+	// write to disk
+	const String dds_file_path = GetCachedPath(inPath);
+	fs::create_directories(Path(dds_file_path).parent_path());
 
-		String filename = Path(inPath).filename().string();
-		std::cout << std::format("[Assets] Image {} at {}x{} is not a power of 2.\n", filename, width, height);
+	std::ofstream dds_file(dds_file_path, std::ios::binary | std::ios::ate);
+	dds_file.write((const char*)dds_buffer.data(), dds_buffer.size());
+
+	if (!dds_file)
+	{
+		std::cout << std::format("[Assets] Failed to write {}\n", dds_file_path);
+		return String();
 	}
 
-	// TODO: gpu mip mapping, cant right now because assets are loaded in parallel but OpenGL can't do multithreading
+	return dds_file_path;
+}
+
 
-	// mips down to 2x2 but DXT works on 4x4 so we subtract one level
-	int nr_of_mips = (int)std::max(std::floor(std::log2(std::max(width, height))) - 1, 0.0);
-	int actual_mip_count = nr_of_mips;
+bool TextureAsset::Save()
+{
+	File file(m_Path, std::ios::binary | std::ios::out);
 
-	for (int mip_index = 1; mip_index < nr_of_mips; mip_index++)
+	if (!file.is_open() || m_Data.empty())
+		return false;
+
+	file.write((const char*)m_Data.data(), m_Data.size());
+
+	return true;
+}
+
+
+bool TextureAsset::Load()
+{
+	std::unique_lock lock(m_DataMutex);
+
+	if (!LoadData())
+		return false;
+
+	m_Header = dds::read_header(m_Data.data(), m_Data.size());
+
+	if (!m_Header.is_valid())
 	{
-		const IVec2 mip_size = IVec2(width >> mip_index, height >> mip_index);
-		const IVec2 prev_mip_size = IVec2(width >> ( mip_index - 1 ), height >> ( mip_index - 1 ));
+		std::cerr << "File " << m_Path << " not a DDS file!\n";
+		ReleaseData();
+		return false;
+	}
 
-		if (!gIsPow2(mip_size.x) || !gIsPow2(mip_size.y))
+	return true;
+}
+
+
+bool TextureAsset::LoadData()
+{
+	if (m_Bundle)
+	{
+		if (!m_Bundle->ReadEntry(*m_BundleEntry, m_Decompressed, m_Data))
+		{
+			std::cerr << "Failed to read " << m_Path << " from " << m_Bundle->GetPath() << '\n';
+			return false;
+		}
+	}
+	else
+	{
+		if (!m_File.Open(m_Path))
 		{
-			actual_mip_count = mip_index;
-			String filename = Path(inPath).filename().string();
-			std::cout << std::format("[Assets] Mip {} of Image {} at {}x{} is not a power of 2\n", mip_index, filename, mip_size.x, mip_size.y);
-			break;
+			std::cerr << "Failed to map " << m_Path << '\n';
+			return false;
 		}
 
-		mip_chain.push_back((stbi_uc*)malloc(mip_size.x * mip_size.y * 4));
-		stbir_resize_uint8_linear(mip_chain[mip_index - 1], prev_mip_size.x, prev_mip_size.y, 0, mip_chain[mip_index], mip_size.x, mip_size.y, 0, STBIR_RGBA);
+		m_Data = ByteSlice(m_File.GetData(), m_File.GetSize());
 	}
 
-	uint32_t offset = 128;
-	Array<unsigned char> dds_buffer(offset);
+	return true;
+}
+
+
+std::shared_lock<SharedMutex> TextureAsset::LockData()
+{
+	std::shared_lock lock(m_DataMutex);
+
+	if (!m_Data.empty())
+		return lock;
+
+	lock.unlock();
 
-	for (int mip_index = 0; mip_index < actual_mip_count; mip_index++)
 	{
-		const IVec2 mip_size = IVec2(width >> mip_index, height >> mip_index);
+		std::unique_lock reload_lock(m_DataMutex);
 
-		if (!gIsPow2(mip_size.x) || !gIsPow2(mip_size.y))
+		// someone else might have beaten us to it
+		if (m_Data.empty() && LoadData())
 		{
-			String filename = Path(inPath).filename().string();
-			std::cout << std::format("[Assets] Mip {} of Image {} at {}x{} is not a power of 2\n", mip_index, filename, mip_size.x, mip_size.y);
-			break;
+			// the file could have been converted again since, mips would be read with the wrong offsets
+			const dds::Header header = dds::read_header(m_Data.data(), m_Data.size());
+
+			if (!header.is_valid() || header.width() != m_Header.width() || header.height() != m_Header.height() || header.format() != m_Header.format() ||
+				header.mip_levels() != m_Header.mip_levels() || header.array_size() != m_Header.array_size())
+			{
+				std::cerr << "File " << m_Path << " changed since it was loaded, request it again.\n";
+				ReleaseData();
+			}
 		}
+	}
 
-		// make room for the new dxt mip
-		dds_buffer.resize(dds_buffer.size() + mip_size.x * mip_size.y);
+	// data might still be empty if loading failed, GetMipData returns nothing in that case
+	lock.lock();
+	return lock;
+}
 
-		// compress data block
-		bool is_dxt5 = true;
-		unsigned char block[64];
-		auto ExtractBlock = [](const unsigned char* src, int x, int y, int w, int h, unsigned char* block)
-		{
-			if (( w - x >= 4 ) && ( h - y >= 4 ))
-			{
-				src += x * 4;
-				src += y * w * 4;
 
-				for (int i = 0; i < 4; ++i)
-				{
-					*(unsigned int*)block = *(unsigned int*)src; block += 4; src += 4;
-					*(unsigned int*)block = *(unsigned int*)src; block += 4; src += 4;
-					*(unsigned int*)block = *(unsigned int*)src; block += 4; src += 4;
-					*(unsigned int*)block = *(unsigned int*)src; block += 4;
-					src += ( w * 4 ) - 12;
-				}
+ByteSlice TextureAsset::GetMipData(uint32_t inMip, uint32_t inLayer) const
+{
+	if (m_Data.empty() || inMip >= m_Header.mip_levels() || inLayer >= m_Header.array_size())
+		return {};
+
+	const uint64_t offset = m_Header.mip_offset(inMip, inLayer);
+	const uint64_t size = m_Header.slice_pitch(inMip);
+
+	// truncated file
+	if (offset + size > m_Data.size())
+		return {};
+
+	return m_Data.subspan(offset, size);
+}
+
+
+Assets::Assets()
+{
+	if (!fs::exists("assets"))
+		fs::create_directory("assets");
+
+	const StaticArray<Pair<const RTTI*, const char*>, 2> budgets =
+	{
+		Pair<const RTTI*, const char*> { &RTTI_OF<TextureAsset>(), "assets_texture_budget_mb" },
+		Pair<const RTTI*, const char*> { &RTTI_OF<ScriptAsset>(), "assets_script_budget_mb" }
+	};
+
+	for (const auto& [index, budget] : gEnumerate(budgets))
+	{
+		m_Budgets[index].m_Type = budget.first;
+		m_Budgets[index].m_DefaultMB = 1024;
+
+		if (g_CVariables)
+			m_Budgets[index].m_BudgetMB = &g_CVariables->Create(budget.second, m_Budgets[index].m_DefaultMB);
+	}
+}
+
+
+void Asset::Wait() const
+{
+	for (EAssetState state = m_State.load(); state < ASSET_READY; state = m_State.load())
+		m_State.wait(state);
+}
 
-				return;
-			}
-		};
 
-		unsigned char* src = mip_chain[mip_index];
-		unsigned char* dst = dds_buffer.data() + offset;
+void Asset::OnLoaded(const Job::Function& inCallback)
+{
+	{
+		std::scoped_lock lock(m_CallbackMutex);
 
-		for (int y = 0; y < mip_size.y; y += 4)
+		if (!IsFinished())
 		{
-			for (int x = 0; x < mip_size.x; x += 4)
-			{
-				ExtractBlock(src, x, y, mip_size.x, mip_size.y, block);
-				stb_compress_dxt_block(dst, block, is_dxt5, 10);
-				dst += is_dxt5 ? 16 : 8;
-			}
+			m_Callbacks.push_back(inCallback);
+			return;
 		}
+	}
 
-		offset += mip_size.x * mip_size.y;
+	inCallback();
+}
+
+
+void Asset::SetFinished(bool inLoaded)
+{
+	Array<Job::Function> callbacks;
+
+	{
+		std::scoped_lock lock(m_CallbackMutex);
+		m_State.store(inLoaded ? ASSET_READY : ASSET_FAILED);
+		callbacks.swap(m_Callbacks);
 	}
 
-	for (stbi_uc* mip : mip_chain)
-		stbi_image_free(mip);
+	m_State.notify_all();
 
-	dds::Header header = {};
-	dds::write_header(&header, dds::DXGI_FORMAT_BC3_UNORM, width, height, actual_mip_count);
-	header.header.ddspf.dwFourCC = dds::fourcc('D', 'X', 'T', '5');
+	for (const Job::Function& callback : callbacks)
+		callback();
+}
 
-	std::memcpy(dds_buffer.data(), &header.magic, sizeof(header.magic));
-	std::memcpy(dds_buffer.data() + sizeof(header.magic), &header.header, sizeof(header.header));
 
-	// write to disk
-	const String dds_file_path = GetCachedPath(inPath);
-	fs::create_directories(Path(dds_file_path).parent_path());
+Asset::Ptr Assets::FindAsset(AssetID inID) const
+{
+	const Shard& shard = GetShard(inID);
+	std::shared_lock lock(shard.m_Mutex);
 
-	std::ofstream dds_file(dds_file_path, std::ios::binary | std::ios::ate);
-	dds_file.write((const char*)dds_buffer.data(), dds_buffer.size());
+	if (auto asset = shard.m_Assets.find(inID); asset != shard.m_Assets.end())
+		return asset->second;
 
-	return dds_file_path;
+	return nullptr;
 }
 
 
-bool TextureAsset::Save()
+bool Assets::MountBundle(const Path& inBundleFile)
 {
-	File file(m_Path, std::ios::binary | std::ios::out);
+	Bundle::Ptr bundle = std::make_shared<Bundle>();
 
-	if (!file.is_open())
+	if (!bundle->Open(inBundleFile))
+	{
+		std::cout << std::format("[Assets] Failed to mount bundle {}.\n", inBundleFile.string());
 		return false;
+	}
 
-	file.write((const char*)m_Data.data(), m_Data.size());
+	std::cout << std::format("[Assets] Mounted bundle {} with {} files.\n", inBundleFile.string(), bundle->GetEntryCount());
+
+	std::unique_lock lock(m_BundleMutex);
+	m_Bundles.push_back(bundle);
 
 	return true;
 }
 
 
-bool TextureAsset::Load()
+uint32_t Assets::MountBundles(const Path& inDirectory)
+{
+	std::error_code error_code;
+	if (!fs::is_directory(inDirectory, error_code))
+		return 0;
+
+	uint32_t mounted = 0;
+
+	for (const fs::directory_entry& entry : fs::recursive_directory_iterator(inDirectory, error_code))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".bundle")
+			mounted += MountBundle(entry.path());
+	}
+
+	return mounted;
+}
+
+
+const BundleEntry* Assets::FindInBundles(StringView inPath, Bundle::Ptr& outBundle) const
 {
-	std::ifstream file(m_Path, std::ios::binary);
+	std::shared_lock lock(m_BundleMutex);
 
-	//constexpr size_t twoMegabytes = 2097152;
-	//std::vector<char> scratch(twoMegabytes);
-	//file.rdbuf()->pubsetbuf(scratch.data(), scratch.size());
+	if (m_Bundles.empty())
+		return nullptr;
 
-	m_Data.resize(fs::file_size(m_Path));
-	file.read((char*)m_Data.data(), m_Data.size());
+	const String path = Bundle::sNormalizePath(inPath);
+	const uint64_t hash = Bundle::sHashPath(path);
 
-	dds::Header header = dds::read_header(m_Data.data(), m_Data.size());
+	for (auto bundle = m_Bundles.rbegin(); bundle != m_Bundles.rend(); bundle++)
+	{
+		if (const BundleEntry* entry = ( *bundle )->FindEntry(path, hash))
+		{
+			outBundle = *bundle;
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+
+void Assets::ReleaseData(const TextureAsset::Ptr& inAsset)
+{
+	// failed or still loading, Load owns the data until it's done
+	if (!inAsset || !inAsset->IsReady())
+		return;
 
-	if (!header.is_valid())
 	{
-		std::cerr << "File " << m_Path << " not a DDS file!\n";;
-		return false;
+		std::unique_lock lock(inAsset->m_DataMutex);
+		inAsset->ReleaseData();
 	}
 
-	return true;
+	// stays pinned by whoever uploaded it, but no longer counts towards the budget
+	if (inAsset->m_ResidentSize.exchange(0) > 0)
+		m_Changes++;
 }
 
 
-Assets::Assets()
+void Assets::LoadAsset(AssetID inID, const Asset::Ptr& inAsset)
 {
-	if (!fs::exists("assets"))
-		fs::create_directory("assets");
+	EAssetState expected = ASSET_QUEUED;
+	if (!inAsset->m_State.compare_exchange_strong(expected, ASSET_LOADING))
+		return;
+
+	const bool loaded = inAsset->Load();
+
+	if (loaded)
+		inAsset->m_ResidentSize.store(inAsset->GetResidentSize());
+
+	// remove failed assets so a later request can try again
+	if (!loaded)
+	{
+		Shard& shard = GetShard(inID);
+		std::unique_lock lock(shard.m_Mutex);
+
+		if (auto asset = shard.m_Assets.find(inID); asset != shard.m_Assets.end() && asset->second == inAsset)
+			shard.m_Assets.erase(asset);
+	}
+
+	m_Changes++;
+	inAsset->SetFinished(loaded);
 }
 
 
-void Assets::ReleaseUnreferenced()
+void Assets::QueueLoadAsset(AssetID inID, const Asset::Ptr& inAsset)
 {
-	Array<String> keys;
+	g_ThreadPool.QueueJob([this, inID, inAsset]() { LoadAsset(inID, inAsset); });
+}
+
+
+bool Assets::ContainsAsset(const String& inPath) const
+{
+	return FindAsset(GetAssetID(inPath)) != nullptr;
+}
 
-	for (const auto& [key, value] : m_Assets)
-		if (value.use_count() == 1)
-			keys.push_back(key);
 
+void Assets::ReleaseUnreferenced()
+{
+	for (Shard& shard : m_Shards)
 	{
-		std::scoped_lock lock(m_Mutex);
-		for (const String& key : keys)
-			m_Assets.erase(key);
+		std::unique_lock lock(shard.m_Mutex);
+
+		// assets that are still loading are referenced by their load job, so they stay
+		std::erase_if(shard.m_Assets, [](const auto& inPair) { return inPair.second.use_count() == 1; });
 	}
+
+	m_Changes++;
+}
+
+
+bool Assets::IsSameAsset(const Asset& inAsset, const String& inPath)
+{
+	if (inAsset.m_RequestedPath == inPath)
+		return true;
+
+	std::cout << std::format("[Assets] Asset ID collision between {} and {}, refusing to load the latter.\n", inAsset.m_RequestedPath, inPath);
+	return false;
 }
 
 
 bool Assets::ReleaseAsset(const String& inFilePath)
 {
-	std::scoped_lock lock(m_Mutex);
+	const AssetID id = GetAssetID(inFilePath);
+
+	Shard& shard = GetShard(id);
+	std::unique_lock lock(shard.m_Mutex);
 
-	if (!m_Assets.contains(inFilePath))
+	if (shard.m_Assets.erase(id) == 0)
 		return false;
 
-	m_Assets.erase(inFilePath);
+	m_Changes++;
 	return true;
 }
 
 
+Assets::Budget* Assets::GetBudget(const RTTI& inType)
+{
+	for (Budget& budget : m_Budgets)
+		if (budget.m_Type == &inType)
+			return &budget;
+
+	return nullptr;
+}
+
+
+const Assets::Budget* Assets::GetBudget(const RTTI& inType) const
+{
+	return const_cast<Assets*>(this)->GetBudget(inType);
+}
+
+
+uint64_t Assets::GetResidentBytes(const RTTI& inType) const
+{
+	const Budget* budget = GetBudget(inType);
+	return budget ? budget->m_ResidentBytes.load() : 0;
+}
+
+
+uint64_t Assets::GetEvictedBytes(const RTTI& inType) const
+{
+	const Budget* budget = GetBudget(inType);
+	return budget ? budget->m_EvictedBytes.load() : 0;
+}
+
+
+void Assets::EvictAsync()
+{
+	const uint64_t frame = ++m_Frame;
+
+	if (m_EvictJob && !m_EvictJob->IsFinished())
+		return;
+
+	// cvars are only written from the main thread, so snapshot them here rather than reading them from the job
+	for (Budget& budget : m_Budgets)
+	{
+		const uint64_t budget_bytes = uint64_t(std::max(*budget.m_BudgetMB, 0)) * 1024 * 1024;
+
+		if (budget.m_BudgetBytes.exchange(budget_bytes) != budget_bytes)
+			m_Changes++;
+	}
+
+	const uint64_t changes = m_Changes.load();
+	if (changes == m_EvictedChanges && !( m_OverBudget && frame % sOverBudgetInterval == 0 ))
+		return;
+
+	m_EvictedChanges = changes;
+	m_EvictJob = g_ThreadPool.QueueJob([this]() { Evict(); });
+}
+
+
+void Assets::Evict()
+{
+	struct Candidate
+	{
+		AssetID id;
+		const Asset* asset;
+		uint64_t lastAccess;
+		size_t size;
+		Budget* budget;
+	};
+
+	Array<Candidate> candidates;
+	StaticArray<uint64_t, std::tuple_size_v<decltype(m_Budgets)>> resident_bytes = {};
+
+	for (Shard& shard : m_Shards)
+	{
+		std::shared_lock lock(shard.m_Mutex);
+
+		for (const auto& [id, asset] : shard.m_Assets)
+		{
+			// the size is only written before the asset finishes loading, so skip anything that hasn't
+			if (!asset->IsFinished())
+				continue;
+
+			Budget* budget = GetBudget(asset->GetRTTI());
+			if (!budget)
+				continue;
+
+			const size_t size = asset->m_ResidentSize.load();
+			resident_bytes[budget - m_Budgets.data()] += size;
+
+			// anything holding a reference besides the registry pins the asset
+			if (size > 0 && asset.use_count() == 1)
+				candidates.push_back(Candidate { id, asset.get(), asset->m_LastAccessFrame.load(std::memory_order_relaxed), size, budget });
+		}
+	}
+
+	for (const auto& [index, budget] : gEnumerate(m_Budgets))
+		budget.m_ResidentBytes = resident_bytes[index];
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& inLHS, const Candidate& inRHS) { return inLHS.lastAccess < inRHS.lastAccess; });
+
+	for (const Candidate& candidate : candidates)
+	{
+		Budget& budget = *candidate.budget;
+
+		if (budget.m_ResidentBytes <= budget.m_BudgetBytes)
+			continue;
+
+		Shard& shard = GetShard(candidate.id);
+		std::unique_lock lock(shard.m_Mutex);
+
+		// it might have been requested or released since we looked
+		auto asset = shard.m_Assets.find(candidate.id);
+		if (asset == shard.m_Assets.end() || asset->second.get() != candidate.asset || asset->second.use_count() != 1)
+			continue;
+
+		shard.m_Assets.erase(asset);
+
+		budget.m_ResidentBytes -= candidate.size;
+		budget.m_EvictedBytes += candidate.size;
+	}
+
+	m_OverBudget = std::any_of(m_Budgets.begin(), m_Budgets.end(), [](const Budget& inBudget) { return inBudget.m_ResidentBytes > inBudget.m_BudgetBytes; });
+}
+
+
+void RunAssetsBenchmark()
+{
+	constexpr uint32_t texture_count = 4096;
+	constexpr uint32_t lookups_per_texture = 5; // every material looks up 5 textures
+
+	const Path directory = fs::temp_directory_path() / "RaekorAssetsBenchmark";
+
+	// a previous run that crashed or got killed could have left its files behind
+	std::error_code error_code;
+	fs::remove_all(directory, error_code);
+	fs::create_directories(directory);
+
+	// tiny 4x4 RGBA textures so the benchmark is dominated by the registry rather than IO
+	Array<String> files(texture_count);
+	Array<uint8_t> dds_buffer(sizeof(dds::Header) + 4 * 4 * 4, 0xFF);
+	dds::write_header(dds_buffer.data(), dds::DXGI_FORMAT_R8G8B8A8_UNORM, 4, 4);
+
+	for (uint32_t index = 0; index < texture_count; index++)
+	{
+		files[index] = ( directory / std::format("texture_{}.dds", index) ).string();
+
+		std::ofstream dds_file(files[index], std::ios::binary);
+		dds_file.write((const char*)dds_buffer.data(), dds_buffer.size());
+	}
+
+	const uint32_t job_count = g_ThreadPool.GetThreadCount() * 4;
+
+	auto RunParallel = [&](Assets& ioAssets)
+	{
+		Atomic<uint32_t> loaded_count = 0;
+
+		for (uint32_t job_index = 0; job_index < job_count; job_index++)
+		{
+			g_ThreadPool.QueueJob([&, job_index]()
+			{
+				// every job walks all the textures from a different starting point so they collide on the same assets
+				for (uint32_t i = 0; i < texture_count; i++)
+				{
+					const String& file = files[( i + job_index * 97 ) % texture_count];
+
+					for (uint32_t lookup = 0; lookup < lookups_per_texture; lookup++)
+						if (ioAssets.GetAsset<TextureAsset>(file))
+							loaded_count++;
+				}
+			});
+		}
+
+		g_ThreadPool.WaitForJobs();
+
+		return loaded_count.load();
+	};
+
+	{
+		Assets assets;
+
+		Timer timer;
+		const uint32_t cold_count = RunParallel(assets);
+		const float cold_time = timer.Restart();
+
+		const uint32_t warm_count = RunParallel(assets);
+		const float warm_time = timer.GetElapsedTime();
+
+		const uint32_t lookup_count = job_count * texture_count * lookups_per_texture;
+
+		if (cold_count != lookup_count || warm_count != lookup_count)
+			std::cout << std::format("[Benchmark] Assets: expected {} successful lookups, got {} cold and {} warm.\n", lookup_count, cold_count, warm_count);
+
+		std::cout << std::format("[Benchmark] Assets: {} textures, {} lookups over {} jobs. Cold {:.3f} ms, warm {:.3f} ms ({:.1f} ns per lookup).\n",
+			texture_count, lookup_count, job_count, Timer::sToMilliseconds(cold_time), Timer::sToMilliseconds(warm_time), ( warm_time * 1e9 ) / lookup_count);
+	}
+
+	// the registry is gone at this point, so none of the files are still mapped
+	fs::remove_all(directory, error_code);
+
+	if (error_code)
+		std::cout << std::format("[Benchmark] Assets: failed to remove {}: {}\n", directory.string(), error_code.message());
+}
+
+
 ScriptAsset::~ScriptAsset()
 {
 	if (m_HModule)
@@ -270,6 +678,13 @@ bool ScriptAsset::Load()
 
 	std::cout << std::format("[Assets] Loaded {}\n", temp_path_str);
 
+	// the module image is what we keep resident, its size on disk is close enough for budgeting
+	std::error_code size_error_code;
+	m_ImageSize = size_t(fs::file_size(m_TempPath, size_error_code));
+
+	if (size_error_code)
+		m_ImageSize = 0;
+
 	if (FARPROC address = GetProcAddress((HMODULE)m_HModule, SCRIPT_EXPORTED_FUNCTION_STR))
 	{
 		INativeScript::RegisterFn GetTypes = (INativeScript::RegisterFn)(address);
@@ -2,9 +2,23 @@
 
 #include "dds.h"
 #include "rtti.h"
+#include "OS.h"
+#include "Threading.h"
+#include "Hash.h"
+#include "TextureCompression.h"
+#include "Bundle.h"
 
 namespace RK {
 
+enum EAssetState
+{
+	ASSET_QUEUED,
+	ASSET_LOADING,
+	ASSET_READY,
+	ASSET_FAILED
+};
+
+
 class Asset
 {
 	RTTI_DECLARE_VIRTUAL_TYPE(Asset);
@@ -13,48 +27,193 @@ public:
 	using Ptr = SharedPtr<Asset>;
 
 	Asset() = default;
-	Asset(const String& inPath) : m_Path(inPath) {}
+	Asset(const String& inPath) : m_Path(inPath), m_RequestedPath(inPath) {}
 	virtual ~Asset() = default;
 
 	virtual bool Load() = 0;
+
+	/* Bytes of CPU memory the asset holds on to, used for budgeting. Only called by Assets on the loading thread right after Load. */
+	virtual size_t GetResidentSize() const { return 0; }
 	
 	Path& GetPath() { return m_Path; }
 	const Path& GetPath() const { return m_Path; }
 
-	static String GetCachedPath(const String& inAssetPath, const char* inExtension)
-	{
-		return fs::relative(inAssetPath).replace_extension(inExtension).string().replace(0, 6, "Cached");
-	}
+	EAssetState GetState() const { return m_State.load(); }
+	bool IsReady() const { return GetState() == ASSET_READY; }
+	bool IsFinished() const { return GetState() >= ASSET_READY; }
+
+	/* Blocks until the asset is either ready or failed to load. */
+	void Wait() const;
+
+	/* Runs inCallback on the loading thread once the asset finished loading, or right away if it already did. */
+	void OnLoaded(const Job::Function& inCallback);
+
+	/* Maps assets/<path>.<ext> to Cached/<path><inExtension>, the compiler's derived data cache materializes its entries there. */
+	static String GetCachedPath(const String& inAssetPath, const char* inExtension);
 
 protected:
 	Path m_Path;
-	String m_String;
+	String m_RequestedPath; // exactly as passed to Assets, compared on lookup since AssetIDs are only a hash
+
+	// set if the asset resolved to an entry in a mounted bundle rather than a loose file
+	Bundle::Ptr m_Bundle;
+	const BundleEntry* m_BundleEntry = nullptr;
+
+private:
+	friend class Assets;
+	void SetFinished(bool inLoaded);
+
+	// only writes when the frame changed so hot assets don't bounce their cache line between threads
+	void Touch(uint64_t inFrame) { if (m_LastAccessFrame.load(std::memory_order_relaxed) != inFrame) m_LastAccessFrame.store(inFrame, std::memory_order_relaxed); }
+
+	Atomic<EAssetState> m_State = ASSET_QUEUED;
+	Atomic<uint64_t> m_LastAccessFrame = 0;
+	Atomic<size_t> m_ResidentSize = 0; // GetResidentSize after loading, so eviction never has to touch the asset's data
+	Mutex m_CallbackMutex;
+	Array<Job::Function> m_Callbacks;
+};
+
+
+/* Typed view of an asset that might still be loading. */
+template<typename T>
+class AssetHandle
+{
+public:
+	using Callback = std::function<void(const SharedPtr<T>&)>;
+
+	AssetHandle() = default;
+	AssetHandle(const SharedPtr<T>& inAsset) : m_Asset(inAsset) {}
+
+	EAssetState GetState() const { return m_Asset ? m_Asset->GetState() : ASSET_FAILED; }
+	bool IsReady() const { return GetState() == ASSET_READY; }
+	bool IsFinished() const { return GetState() >= ASSET_READY; }
+
+	/* Returns the asset once it's ready, nullptr while it's still loading or if it failed. */
+	SharedPtr<T> Get() const { return IsReady() ? m_Asset : nullptr; }
+
+	/* Blocks until the asset finished loading, nullptr if it failed. */
+	SharedPtr<T> Wait() const;
+
+	explicit operator bool() const { return m_Asset != nullptr; }
+
+private:
+	SharedPtr<T> m_Asset;
 };
 
 
+/* Assets are keyed by a hash of their path, computed once per request. */
+using AssetID = uint64_t;
+
+
 class Assets
 {
 public:
 	Assets();
-	~Assets() = default;
+	~Assets() { if (m_EvictJob) m_EvictJob->WaitCPU(); }
 
-	/* Request an asset given inPath. Will load the asset from disk if it wasn't already. This function is thread-safe (so you can load assets in parallel). */
-	/* You might get an asset that's still loading on another thread though... REWORK TIME! */
+	/* Get an asset given inPath, blocks until it's loaded. Loads it on the calling thread if nobody else picked it up yet,
+		otherwise waits for the thread that did. Thread-safe, returns nullptr if the file doesn't exist or failed to load. */
 	template<typename T> SharedPtr<T> GetAsset(const String& inPath);
 	template<typename T> SharedPtr<T> GetAsset(const Path& inPath) { return GetAsset<T>(inPath.string()); }
 
+	/* Schedules loading inPath on the thread pool and returns right away. inOnLoaded is called from the loading thread
+		once it's done (or immediately if the asset already finished loading), with nullptr if loading failed. */
+	template<typename T> AssetHandle<T> RequestAsset(const String& inPath, const typename AssetHandle<T>::Callback& inOnLoaded = nullptr);
+	template<typename T> AssetHandle<T> RequestAsset(const Path& inPath, const typename AssetHandle<T>::Callback& inOnLoaded = nullptr) { return RequestAsset<T>(inPath.string(), inOnLoaded); }
+
 	bool ReleaseAsset(const String& inPath);
-	bool ContainsAsset(const String& inPath) const { return m_Assets.contains(inPath); }
+	bool ContainsAsset(const String& inPath) const;
+
+	/* Drops inAsset's CPU copy of its data once it lives on the GPU, the asset stays registered. Waits for uploads still reading it,
+		uploading it again later maps the data again. Thread-safe. */
+	void ReleaseData(const SharedPtr<class TextureAsset>& inAsset);
 
 	/* Releases any assets that are no longer referenced elsewhere. */
 	void ReleaseUnreferenced();
 
+	/* Call once per frame from the main thread. Queues a background job that evicts the least recently used assets of every type that's over its
+		memory budget (see the assets_*_budget_mb cvars), but only if assets were added, loaded or released or a budget changed since the last run.
+		Assets referenced outside the registry (e.g. by a Material, DirectionalLight or NativeScript) are pinned and never evicted. */
+	void EvictAsync();
+
+	uint64_t GetResidentBytes(const RTTI& inType) const;
+	uint64_t GetEvictedBytes(const RTTI& inType) const;
+
+	static AssetID GetAssetID(StringView inPath) { return gHashFNV1a(inPath.data(), inPath.size()); }
+
+	/* Mounted bundles are searched before the loose file system, most recently mounted first. Only affects assets created afterwards. */
+	bool MountBundle(const Path& inBundleFile);
+	
+	/* Mounts every .bundle file in inDirectory and its subdirectories, returns how many were mounted. */
+	uint32_t MountBundles(const Path& inDirectory);
+
 private:
-	std::mutex m_Mutex;
-	HashMap<String, Asset::Ptr> m_Assets;
+	/* Returns the entry for inPath in the most recently mounted bundle that has it, nullptr if none do. */
+	const BundleEntry* FindInBundles(StringView inPath, Bundle::Ptr& outBundle) const;
+
+	/* Returns the asset for inID if it's registered, only takes a shared lock on its shard. */
+	Asset::Ptr FindAsset(AssetID inID) const;
+
+	/* Returns the existing asset for inID or inserts a new (queued) one if inPath exists on disk. */
+	template<typename T> SharedPtr<T> FindOrCreateAsset(AssetID inID, const String& inPath, bool& outCreated);
+
+	/* False (and logs) if inAsset was registered under a different path that hashed to the same AssetID. */
+	static bool IsSameAsset(const Asset& inAsset, const String& inPath);
+
+	/* Loads inAsset on the calling thread if it's still queued, does nothing if another thread already picked it up. */
+	void LoadAsset(AssetID inID, const Asset::Ptr& inAsset);
+	void QueueLoadAsset(AssetID inID, const Asset::Ptr& inAsset);
+
+	void Evict();
+
+	struct Budget
+	{
+		const RTTI* m_Type = nullptr;
+		int m_DefaultMB = 0;
+		int* m_BudgetMB = &m_DefaultMB; // points to the cvar once it's created
+		Atomic<uint64_t> m_BudgetBytes = 0; // snapshot of the cvar taken on the main thread, the evict job only reads this
+		Atomic<uint64_t> m_ResidentBytes = 0;
+		Atomic<uint64_t> m_EvictedBytes = 0;
+	};
+
+	Budget* GetBudget(const RTTI& inType);
+	const Budget* GetBudget(const RTTI& inType) const;
+
+	/* Lookups vastly outnumber inserts, so the registry is split into shards that each have their own reader-writer lock. */
+	struct alignas(64) Shard
+	{
+		mutable SharedMutex m_Mutex;
+		HashMap<AssetID, Asset::Ptr> m_Assets;
+	};
+
+	static constexpr uint32_t sShardCount = 64;
+
+	// use the top bits, the low bits already pick the bucket inside the shard's map
+	Shard& GetShard(AssetID inID) { return m_Shards[inID >> 58]; }
+	const Shard& GetShard(AssetID inID) const { return m_Shards[inID >> 58]; }
+
+	StaticArray<Shard, sShardCount> m_Shards;
+	StaticArray<Budget, 2> m_Budgets;
+	Atomic<uint64_t> m_Frame = 1;
+	Job::Ptr m_EvictJob;
+
+	// bumped whenever the registry or a budget changes, EvictAsync skips walking the shards if nothing did
+	Atomic<uint64_t> m_Changes = 0;
+	uint64_t m_EvictedChanges = 0;
+	Atomic<bool> m_OverBudget = false;
+
+	// assets over budget can get unpinned by components letting go of them, which the registry doesn't see, so recheck every so often
+	static constexpr uint64_t sOverBudgetInterval = 30;
+
+	mutable SharedMutex m_BundleMutex;
+	Array<Bundle::Ptr> m_Bundles;
 };
 
 
+/* Loads thousands of tiny textures from all worker threads at once, then looks them up again, to measure registry contention. */
+void RunAssetsBenchmark();
+
+
 class TextureAsset : public Asset
 {
 public:
@@ -68,16 +227,45 @@ public:
 
 	[[deprecated]] bool Save();
 
+	/* Memory maps the .dds file (or points into its bundle) and parses its header. Called once by Assets, the data stays mapped
+		until Assets::ReleaseData, the header never changes after this. */
 	virtual bool Load() override;
-	static String Convert(const String& inPath);
+	virtual size_t GetResidentSize() const override { return m_Data.size(); }
+
+	/* Bump whenever Convert's output changes, invalidates every texture in the derived data cache. */
+	static constexpr uint32_t sConverterVersion = 3;
+
+	/* Converts an image to a block compressed .dds with a full mip chain in the cache, the format is picked based on inUsage. Returns the cached path, empty on failure. */
+	static String Convert(const String& inPath, ETextureUsage inUsage = TEXTURE_USAGE_AUTO, EMipFilter inFilter = MIP_FILTER_MITCHELL);
 	static String GetCachedPath(const String& inPath) { return Asset::GetCachedPath(inPath, ".dds"); }
 
+	/* Keeps the data around for as long as the returned lock is held, maps it again first if it was released.
+		Only call on ready assets, anything that reads the data below has to hold this. */
+	std::shared_lock<SharedMutex> LockData();
+
+	bool IsDataLoaded() const { return !m_Data.empty(); }
+
+	const dds::Header& GetHeader() const { return m_Header; }
+	uint32_t GetMipCount() const { return m_Header.mip_levels(); }
+
+	/* View of a single mip of a single array layer or cube face, empty if out of range or the data isn't loaded. */
+	ByteSlice GetMipData(uint32_t inMip, uint32_t inLayer = 0) const;
+
 	const size_t GetDataSize() const { return m_Data.size(); }
 	const uint8_t* const GetData() const { return m_Data.data(); }
 
 private:
-	Array<uint8_t> m_Data;
-	uint32_t m_Texture = 0;
+	friend class Assets;
+
+	/* Maps the file or reads the bundle entry, without touching the header. */
+	bool LoadData();
+	void ReleaseData() { m_Data = {}; m_File.Close(); m_Decompressed = {}; }
+
+	SharedMutex m_DataMutex; // shared while reading the data, unique while (re)loading or releasing it
+	ByteSlice m_Data;
+	OS::MappedFile m_File;
+	Array<uint8_t> m_Decompressed; // only used for LZ4 compressed bundle entries
+	dds::Header m_Header = {};
 };
 
 
@@ -94,6 +282,8 @@ public:
 	virtual ~ScriptAsset();
 
 	virtual bool Load() override;
+	virtual size_t GetResidentSize() const override { return m_ImageSize; }
+
 	static String Convert(const String& inPath);
 	static String GetCachedPath(const String& inPath) { return Asset::GetCachedPath(inPath, ".dll"); }
 
@@ -103,6 +293,7 @@ public:
 private:
 	Path m_TempPath;
 	void* m_HModule = nullptr;
+	size_t m_ImageSize = 0;
 	Array<String> m_RegisteredTypes;
 };
 
@@ -112,41 +303,101 @@ private:
 namespace RK {
 
 template<typename T>
-SharedPtr<T> Assets::GetAsset(const String& inPath)
+SharedPtr<T> AssetHandle<T>::Wait() const
+{
+	if (!m_Asset)
+		return nullptr;
+
+	m_Asset->Wait();
+	return Get();
+}
+
+
+template<typename T>
+SharedPtr<T> Assets::FindOrCreateAsset(AssetID inID, const String& inPath, bool& outCreated)
 {
-    SharedPtr<T> asset_ptr = nullptr;
+	outCreated = false;
 
+	if (Asset::Ptr asset = FindAsset(inID))
 	{
-		std::scoped_lock lock(m_Mutex);
-
-		// if it already has an asset pointer it means some other thread added it,
-		// so just return whats there, the thread that added it is responsible for loading.
-        if (auto asset = m_Assets.find(inPath); asset != m_Assets.end())
-        {
-			return std::static_pointer_cast<T>( asset->second );
-        }
-		// if there is no asset pointer already and the file path exists on disk, insert it
-        else if (fs::exists(inPath) && fs::is_regular_file(inPath))
-        {
-            asset_ptr = std::make_shared<T>(inPath);
-			m_Assets.insert(std::make_pair(inPath, asset_ptr));
-        }
-        else
-        {
-			// can't load anything if it doesn't exist on disk
+		if (!IsSameAsset(*asset, inPath))
 			return nullptr;
-        }
+
+		asset->Touch(m_Frame.load(std::memory_order_relaxed));
+		return std::static_pointer_cast<T>(asset);
 	}
-	// only get here if this thread created the asset pointer, try to load it.
-	// if load succeeds we return the asset pointer
-	if (asset_ptr->Load())
-		return asset_ptr;
-	else
+
+	// hitting the file system is slow, don't hold up other threads while doing so
+	Bundle::Ptr bundle;
+	const BundleEntry* bundle_entry = FindInBundles(inPath, bundle);
+
+	std::error_code error_code;
+	if (!bundle_entry && !fs::is_regular_file(inPath, error_code))
+		return nullptr;
+
+	Shard& shard = GetShard(inID);
+	std::unique_lock lock(shard.m_Mutex);
+
+	// some other thread might have inserted it in the meantime, in which case we return theirs
+	auto [asset, inserted] = shard.m_Assets.try_emplace(inID, nullptr);
+	if (inserted)
 	{
-		// if load failed, lock -> remove asset pointer -> return nullptr
-		ReleaseAsset(inPath);
+		asset->second = std::make_shared<T>(inPath);
+		asset->second->m_Bundle = bundle;
+		asset->second->m_BundleEntry = bundle_entry;
+		outCreated = true;
+		m_Changes++;
+	}
+
+	if (!IsSameAsset(*asset->second, inPath))
 		return nullptr;
+
+	asset->second->Touch(m_Frame.load(std::memory_order_relaxed));
+
+	return std::static_pointer_cast<T>(asset->second);
+}
+
+
+template<typename T>
+SharedPtr<T> Assets::GetAsset(const String& inPath)
+{
+	bool created = false;
+	const AssetID id = GetAssetID(inPath);
+	SharedPtr<T> asset = FindOrCreateAsset<T>(id, inPath, created);
+
+	if (!asset)
+		return nullptr;
+
+	// if it's still queued we load it ourselves rather than waiting on the thread pool (which might be us)
+	LoadAsset(id, asset);
+	asset->Wait();
+
+	return asset->IsReady() ? asset : nullptr;
+}
+
+
+template<typename T>
+AssetHandle<T> Assets::RequestAsset(const String& inPath, const typename AssetHandle<T>::Callback& inOnLoaded)
+{
+	bool created = false;
+	const AssetID id = GetAssetID(inPath);
+	SharedPtr<T> asset = FindOrCreateAsset<T>(id, inPath, created);
+
+	if (!asset)
+	{
+		if (inOnLoaded)
+			inOnLoaded(nullptr);
+
+		return AssetHandle<T>();
 	}
+
+	if (inOnLoaded)
+		asset->OnLoaded([asset, inOnLoaded]() { inOnLoaded(asset->IsReady() ? asset : nullptr); });
+
+	if (created)
+		QueueLoadAsset(id, asset);
+
+	return AssetHandle<T>(asset);
 }
 
-}
\ No newline at end of file
+}
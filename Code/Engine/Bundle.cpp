@@ -0,0 +1,248 @@
+#include "PCH.h"
+#include "Bundle.h"
+#include "Hash.h"
+#include "Scene.h"
+#include "Components.h"
+
+namespace RK {
+
+String Bundle::sNormalizePath(StringView inPath)
+{
+	String path = String(inPath);
+
+	for (char& c : path)
+		c = c == '\\' ? '/' : char(std::tolower(uint8_t(c)));
+
+	return path;
+}
+
+
+bool Bundle::Open(const Path& inPath)
+{
+	m_Path = inPath;
+	m_Entries = {};
+
+	if (!m_File.Open(inPath))
+		return false;
+
+	const uint8_t* data = m_File.GetData();
+	const size_t size = m_File.GetSize();
+
+	if (size < sizeof(BundleHeader))
+	{
+		m_File.Close();
+		return false;
+	}
+
+	BundleHeader header;
+	std::memcpy(&header, data, sizeof(BundleHeader));
+
+	if (header.MagicNumber != BundleHeader::sMagicNumber || header.Version != BundleHeader::sVersion)
+	{
+		std::cout << std::format("[Bundle] {} is not a valid bundle or has an outdated version.\n", inPath.string());
+		m_File.Close();
+		return false;
+	}
+
+	if (header.TOCOffset % alignof(BundleEntry) != 0 || header.TOCOffset + uint64_t(header.EntryCount) * sizeof(BundleEntry) > size || header.PathsOffset + header.PathsSize > size)
+	{
+		std::cout << std::format("[Bundle] {} has a corrupt table of contents.\n", inPath.string());
+		m_File.Close();
+		return false;
+	}
+
+	m_Entries = Slice<const BundleEntry>((const BundleEntry*)( data + header.TOCOffset ), header.EntryCount);
+	m_Paths = StringView((const char*)( data + header.PathsOffset ), header.PathsSize);
+
+	return true;
+}
+
+
+const BundleEntry* Bundle::FindEntry(StringView inNormalizedPath, uint64_t inHash) const
+{
+	auto entry = std::lower_bound(m_Entries.begin(), m_Entries.end(), inHash, [](const BundleEntry& inEntry, uint64_t inHash) { return inEntry.pathHash < inHash; });
+
+	// different paths can share a hash, those sit next to each other
+	for (; entry != m_Entries.end() && entry->pathHash == inHash; entry++)
+	{
+		if (uint64_t(entry->pathOffset) + entry->pathLength > m_Paths.size())
+			continue;
+
+		if (m_Paths.substr(entry->pathOffset, entry->pathLength) == inNormalizedPath)
+			return &*entry;
+	}
+
+	return nullptr;
+}
+
+
+bool Bundle::ReadEntry(const BundleEntry& inEntry, Array<uint8_t>& ioStorage, ByteSlice& outData) const
+{
+	if (!m_File.IsOpen() || inEntry.offset + inEntry.size > m_File.GetSize())
+		return false;
+
+	const uint8_t* data = m_File.GetData() + inEntry.offset;
+
+	if (( inEntry.flags & BUNDLE_ENTRY_LZ4 ) == 0)
+	{
+		outData = ByteSlice(data, inEntry.size);
+		return true;
+	}
+
+	ioStorage.resize(inEntry.uncompressedSize);
+
+	const int decompressed_size = LZ4_decompress_safe((const char*)data, (char*)ioStorage.data(), int(inEntry.size), int(inEntry.uncompressedSize));
+	if (decompressed_size < 0 || uint64_t(decompressed_size) != inEntry.uncompressedSize)
+	{
+		std::cout << std::format("[Bundle] Failed to decompress entry {:016x} from {}.\n", inEntry.pathHash, m_Path.string());
+		ioStorage.clear();
+		return false;
+	}
+
+	outData = ByteSlice(ioStorage.data(), ioStorage.size());
+	return true;
+}
+
+
+void BundleWriter::AddFile(const String& inPath, const Path& inFile, bool inAllowCompression)
+{
+	if (inPath.empty())
+		return;
+
+	// materials share textures, only pack them once
+	const String path = Bundle::sNormalizePath(inPath);
+	if (!m_FileIndices.try_emplace(path, uint32_t(m_Files.size())).second)
+		return;
+
+	m_Files.push_back(File { .path = path, .file = inFile, .allowCompression = inAllowCompression });
+}
+
+
+bool BundleWriter::Write(const Path& inBundleFile) const
+{
+	std::error_code error_code;
+	fs::create_directories(inBundleFile.parent_path(), error_code);
+
+	std::ofstream bundle_file(inBundleFile, std::ios::binary);
+	if (!bundle_file.is_open())
+		return false;
+
+	BundleHeader header = {};
+	header.MagicNumber = BundleHeader::sMagicNumber;
+	header.Version = BundleHeader::sVersion;
+	bundle_file.write((const char*)&header, sizeof(header));
+
+	const auto WritePadding = [&](uint64_t inAlignment)
+	{
+		const uint64_t offset = bundle_file.tellp();
+		const uint64_t padding = gAlignUp(offset, inAlignment) - offset;
+
+		static constexpr StaticArray<char, BundleHeader::sEntryAlignment> sZeroes = {};
+		bundle_file.write(sZeroes.data(), padding);
+	};
+
+	Array<BundleEntry> entries;
+	Array<uint8_t> contents;
+	Array<uint8_t> compressed;
+	String paths;
+
+	for (const File& file : m_Files)
+	{
+		std::ifstream input_file(file.file, std::ios::binary | std::ios::ate);
+		if (!input_file.is_open())
+		{
+			std::cout << std::format("[Bundle] Skipping {}, failed to open {}.\n", file.path, file.file.string());
+			continue;
+		}
+
+		contents.resize(input_file.tellg());
+		input_file.seekg(0);
+		input_file.read((char*)contents.data(), contents.size());
+
+		BundleEntry entry = {};
+		entry.pathHash = Bundle::sHashPath(file.path);
+		entry.pathOffset = uint32_t(paths.size());
+		entry.pathLength = uint32_t(file.path.size());
+		entry.uncompressedSize = contents.size();
+
+		paths += file.path;
+
+		ByteSlice data = ByteSlice(contents.data(), contents.size());
+
+		if (file.allowCompression && !contents.empty() && contents.size() < INT_MAX)
+		{
+			compressed.resize(LZ4_compressBound(int(contents.size())));
+			const int compressed_size = LZ4_compress_default((const char*)contents.data(), (char*)compressed.data(), int(contents.size()), int(compressed.size()));
+
+			// block compressed textures barely shrink, keep those uncompressed so they can be used straight from the mapping
+			if (compressed_size > 0 && uint64_t(compressed_size) < contents.size() - contents.size() / 10)
+			{
+				entry.flags |= BUNDLE_ENTRY_LZ4;
+				data = ByteSlice(compressed.data(), compressed_size);
+			}
+		}
+
+		WritePadding(BundleHeader::sEntryAlignment);
+
+		entry.offset = bundle_file.tellp();
+		entry.size = data.size();
+		bundle_file.write((const char*)data.data(), data.size());
+
+		entries.push_back(entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const BundleEntry& inA, const BundleEntry& inB) { return inA.pathHash < inB.pathHash; });
+
+	WritePadding(alignof(BundleEntry));
+
+	header.EntryCount = uint32_t(entries.size());
+	header.TOCOffset = bundle_file.tellp();
+	bundle_file.write((const char*)entries.data(), entries.size() * sizeof(BundleEntry));
+
+	header.PathsOffset = bundle_file.tellp();
+	header.PathsSize = paths.size();
+	bundle_file.write(paths.data(), paths.size());
+
+	bundle_file.seekp(0);
+	bundle_file.write((const char*)&header, sizeof(header));
+
+	return bundle_file.good();
+}
+
+
+bool gBuildSceneBundle(const Path& inSceneFile, const Path& inBundleFile)
+{
+	Scene scene(nullptr);
+
+	String error;
+	if (!scene.ReadFromFile(inSceneFile, error))
+	{
+		std::cout << std::format("[Bundle] Failed to read {}: {}\n", inSceneFile.string(), error);
+		return false;
+	}
+
+	BundleWriter writer;
+
+	// scene archives are read through their own path, but pack them anyway so a level ships as a single file
+	writer.AddFile(inSceneFile.generic_string(), inSceneFile);
+
+	for (const auto& [entity, material] : scene.Each<Material>())
+	{
+		for (const String& file : { material.albedoFile, material.normalFile, material.emissiveFile, material.metallicFile, material.roughnessFile })
+			writer.AddFile(file, file);
+	}
+
+	for (const auto& [entity, light] : scene.Each<DirectionalLight>())
+		writer.AddFile(light.cubeMapFile, light.cubeMapFile);
+
+	if (!writer.Write(inBundleFile))
+	{
+		std::cout << std::format("[Bundle] Failed to write {}.\n", inBundleFile.string());
+		return false;
+	}
+
+	std::cout << std::format("[Bundle] Packed {} files from {} into {}.\n", writer.GetFileCount(), inSceneFile.string(), inBundleFile.string());
+	return true;
+}
+
+} // namespace RK
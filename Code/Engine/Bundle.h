@@ -0,0 +1,106 @@
+#pragma once
+
+#include "OS.h"
+#include "Hash.h"
+
+namespace RK {
+
+/*
+	Bundle file layout:
+		BundleHeader
+		entries, each aligned to sEntryAlignment so uncompressed entries can be used straight from the mapping
+		table of contents, BundleEntry[EntryCount] sorted by path hash
+		path table, the normalized paths of all entries back to back, so lookups can tell colliding hashes apart
+*/
+struct BundleHeader
+{
+	static constexpr uint32_t sVersion = 2;
+	static constexpr uint32_t sMagicNumber = 0x524B424E; // RKBN
+	static constexpr uint64_t sEntryAlignment = 4096;
+
+	uint64_t MagicNumber;
+	uint32_t Version;
+	uint32_t EntryCount;
+	uint64_t TOCOffset;
+	uint64_t PathsOffset;
+	uint64_t PathsSize;
+};
+
+
+enum EBundleEntryFlags : uint32_t
+{
+	BUNDLE_ENTRY_NONE = 0,
+	BUNDLE_ENTRY_LZ4 = 1 << 0
+};
+
+
+struct BundleEntry
+{
+	uint64_t pathHash;
+	uint64_t offset;
+	uint64_t size; // size in the bundle, compressed if BUNDLE_ENTRY_LZ4 is set
+	uint64_t uncompressedSize;
+	uint32_t pathOffset; // into the path table
+	uint32_t pathLength;
+	uint32_t flags;
+	uint32_t padding;
+};
+
+
+/* Read only, memory mapped bundle. Thread-safe once opened. */
+class Bundle
+{
+public:
+	using Ptr = SharedPtr<Bundle>;
+
+	bool Open(const Path& inPath);
+	const Path& GetPath() const { return m_Path; }
+
+	/* Paths are compared case insensitive with forward slashes, so Cached\Foo.dds and cached/foo.dds hit the same entry. */
+	static String sNormalizePath(StringView inPath);
+	static uint64_t sHashPath(StringView inNormalizedPath) { return gHashFNV1a(inNormalizedPath.data(), inNormalizedPath.size()); }
+
+	const BundleEntry* FindEntry(StringView inPath) const { const String path = sNormalizePath(inPath); return FindEntry(path, sHashPath(path)); }
+
+	/* Looks up inHash, but only returns an entry whose stored path matches inNormalizedPath. */
+	const BundleEntry* FindEntry(StringView inNormalizedPath, uint64_t inHash) const;
+
+	uint32_t GetEntryCount() const { return uint32_t(m_Entries.size()); }
+
+	/* Uncompressed entries point straight into the mapped bundle, compressed entries are decompressed into ioStorage. */
+	bool ReadEntry(const BundleEntry& inEntry, Array<uint8_t>& ioStorage, ByteSlice& outData) const;
+
+private:
+	Path m_Path;
+	OS::MappedFile m_File;
+	Slice<const BundleEntry> m_Entries;
+	StringView m_Paths;
+};
+
+
+class BundleWriter
+{
+public:
+	/* Adds inFile under inPath (the path the runtime requests it by). Compressed with LZ4 if that saves at least 10%. */
+	void AddFile(const String& inPath, const Path& inFile, bool inAllowCompression = true);
+	bool Write(const Path& inBundleFile) const;
+
+	uint32_t GetFileCount() const { return uint32_t(m_Files.size()); }
+
+private:
+	struct File
+	{
+		String path; // normalized
+		Path file;
+		bool allowCompression;
+	};
+
+	Array<File> m_Files;
+	HashMap<String, uint32_t> m_FileIndices;
+};
+
+
+/* Packs a compiled scene and every texture it references into a single bundle. */
+bool gBuildSceneBundle(const Path& inSceneFile, const Path& inBundleFile);
+
+} // namespace RK
@@ -52,6 +52,7 @@ RTTI_DEFINE_TYPE(Light)
 }
 
 
+// keep in sync with RTTI_DECLARE_SERIALIZER in Mesh
 RTTI_DEFINE_TYPE(Mesh)
 {
 	RTTI_DEFINE_MEMBER(Mesh, SERIALIZE_ALL, "BBox", bbox);
@@ -62,6 +63,23 @@ RTTI_DEFINE_TYPE(Mesh)
 	RTTI_DEFINE_MEMBER(Mesh, SERIALIZE_ALL, "Vertices", vertices);
 	RTTI_DEFINE_MEMBER(Mesh, SERIALIZE_ALL, "Indices", indices);
 	RTTI_DEFINE_MEMBER(Mesh, SERIALIZE_ALL, "Material", material);
+	RTTI_DEFINE_MEMBER(Mesh, SERIALIZE_ALL, "Meshlets", meshlets);
+	RTTI_DEFINE_MEMBER(Mesh, SERIALIZE_ALL, "Meshlet Indices", meshletIndices);
+	RTTI_DEFINE_MEMBER(Mesh, SERIALIZE_ALL, "Meshlet Triangles", meshletTriangles);
+}
+
+
+RTTI_DEFINE_TYPE(Meshlet)
+{
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Vertex Offset", mVertexOffset);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Triangle Offset", mTriangleOffset);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Vertex Count", mVertexCount);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Triangle Count", mTriangleCount);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Center", mCenter);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Radius", mRadius);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Cone Apex", mConeApex);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Cone Axis", mConeAxis);
+	RTTI_DEFINE_MEMBER(Meshlet, SERIALIZE_ALL, "Cone Cutoff", mConeCutoff);
 }
 
 
@@ -79,6 +97,7 @@ RTTI_DEFINE_TYPE(SoftBody)
 }
 
 
+// keep in sync with RTTI_DECLARE_SERIALIZER in Skeleton::Bone
 RTTI_DEFINE_TYPE(Skeleton::Bone)
 {
 	RTTI_DEFINE_MEMBER(Skeleton::Bone, SERIALIZE_ALL, "Index", index);
@@ -87,6 +106,7 @@ RTTI_DEFINE_TYPE(Skeleton::Bone)
 }
 
 
+// keep in sync with RTTI_DECLARE_SERIALIZER in Skeleton
 RTTI_DEFINE_TYPE(Skeleton)
 {
 	RTTI_DEFINE_MEMBER(Skeleton, SERIALIZE_ALL, "Animation", animation);
@@ -145,6 +165,7 @@ void gRegisterComponentTypes()
 	g_RTTIFactory.Register(RTTI_OF<Name>());
 	g_RTTIFactory.Register(RTTI_OF<Transform>());
     g_RTTIFactory.Register(RTTI_OF<Mesh>());
+    g_RTTIFactory.Register(RTTI_OF<Meshlet>());
     g_RTTIFactory.Register(RTTI_OF<Camera>());
 	g_RTTIFactory.Register(RTTI_OF<Material>());
 	g_RTTIFactory.Register(RTTI_OF<Animation>());
@@ -598,6 +619,123 @@ void Mesh::CalculateVertices()
 }
 
 
+void Mesh::CalculateMeshlets()
+{
+	meshlets.clear();
+	meshletIndices.clear();
+	meshletTriangles.clear();
+
+	if (indices.empty() || positions.empty())
+		return;
+
+	const size_t max_meshlets = meshopt_buildMeshletsBound(indices.size(), sMeshletMaxVertices, sMeshletMaxTriangles);
+
+	Array<meshopt_Meshlet> opt_meshlets(max_meshlets);
+	Array<uint32_t> meshlet_vertices(max_meshlets * sMeshletMaxVertices);
+	Array<uint8_t> meshlet_triangles(max_meshlets * sMeshletMaxTriangles * 3);
+
+	// trade a little vertex reuse for tighter normal cones, so more meshlets can be backface culled
+	const float cone_weight = 0.25f;
+
+	const size_t meshlet_count = meshopt_buildMeshlets(opt_meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(), indices.data(), indices.size(),
+		&positions[0].x, positions.size(), sizeof(Vec3), sMeshletMaxVertices, sMeshletMaxTriangles, cone_weight);
+
+	meshlets.reserve(meshlet_count);
+	meshletIndices.reserve(meshlet_count * sMeshletMaxVertices);
+	meshletTriangles.reserve(indices.size() / 3);
+
+	for (const meshopt_Meshlet& opt_meshlet : Slice(opt_meshlets.data(), meshlet_count))
+	{
+		const meshopt_Bounds bounds = meshopt_computeMeshletBounds(&meshlet_vertices[opt_meshlet.vertex_offset], &meshlet_triangles[opt_meshlet.triangle_offset],
+			opt_meshlet.triangle_count, &positions[0].x, positions.size(), sizeof(Vec3));
+
+		Meshlet& meshlet = meshlets.emplace_back();
+		meshlet.mVertexOffset = uint32_t(meshletIndices.size());
+		meshlet.mTriangleOffset = uint32_t(meshletTriangles.size());
+		meshlet.mVertexCount = opt_meshlet.vertex_count;
+		meshlet.mTriangleCount = opt_meshlet.triangle_count;
+		meshlet.mCenter = Vec3(bounds.center[0], bounds.center[1], bounds.center[2]);
+		meshlet.mRadius = bounds.radius;
+		meshlet.mConeApex = Vec3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+		meshlet.mConeAxis = Vec3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+		meshlet.mConeCutoff = bounds.cone_cutoff;
+
+		// meshopt leaves gaps between meshlets, store them tightly packed
+		const auto vertices_begin = meshlet_vertices.begin() + opt_meshlet.vertex_offset;
+		meshletIndices.insert(meshletIndices.end(), vertices_begin, vertices_begin + opt_meshlet.vertex_count);
+
+		for (uint32_t triangle = 0; triangle < opt_meshlet.triangle_count; triangle++)
+		{
+			const uint8_t* local_indices = &meshlet_triangles[opt_meshlet.triangle_offset + triangle * 3];
+			meshletTriangles.push_back(uint32_t(local_indices[0]) | ( uint32_t(local_indices[1]) << 10 ) | ( uint32_t(local_indices[2]) << 20 ));
+		}
+	}
+}
+
+
+void Mesh::Optimize(Skeleton* ioSkeleton)
+{
+	const size_t vertex_count = positions.size();
+
+	if (indices.empty() || vertex_count == 0)
+		return;
+
+	// every attribute has to line up with the positions, otherwise there's no consistent order to remap them to
+	const auto IsPerVertex = [vertex_count](const auto& inArray) { return inArray.empty() || inArray.size() == vertex_count; };
+
+	if (!IsPerVertex(uvs) || !IsPerVertex(normals) || !IsPerVertex(tangents))
+		return;
+
+	if (ioSkeleton && ( !IsPerVertex(ioSkeleton->boneWeights) || !IsPerVertex(ioSkeleton->boneIndices) ))
+		return;
+
+	meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertex_count);
+
+	// overdraw optimization can make the cache hit rate worse by up to this factor
+	const float cache_threshold = 1.05f;
+	meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &positions[0].x, vertex_count, sizeof(Vec3), cache_threshold);
+
+	Array<uint32_t> remap(vertex_count);
+	const size_t unique_vertex_count = meshopt_optimizeVertexFetchRemap(remap.data(), indices.data(), indices.size(), vertex_count);
+
+	meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+
+	const auto Remap = [&]<typename T>(Array<T>& ioArray)
+	{
+		if (ioArray.empty())
+			return;
+
+		Array<T> remapped(unique_vertex_count);
+		meshopt_remapVertexBuffer(remapped.data(), ioArray.data(), vertex_count, sizeof(T), remap.data());
+		ioArray = std::move(remapped);
+	};
+
+	Remap(positions);
+	Remap(uvs);
+	Remap(normals);
+	Remap(tangents);
+
+	if (ioSkeleton)
+	{
+		Remap(ioSkeleton->boneWeights);
+		Remap(ioSkeleton->boneIndices);
+	}
+
+	CalculateBoundingBox();
+	CalculateVertices();
+
+	// meshlets index into the old vertex order
+	if (!meshlets.empty())
+		CalculateMeshlets();
+}
+
+
+meshopt_VertexCacheStatistics Mesh::AnalyzeVertexCache() const
+{
+	return meshopt_analyzeVertexCache(indices.data(), indices.size(), positions.size(), sVertexCacheSize, 0, 0);
+}
+
+
 uint32_t Mesh::GetVertexStride() const
 {
 	uint32_t stride = 0u;
@@ -779,4 +917,84 @@ void AudioStream::Play()
 }
 
 
+void RunComponentSerializationBenchmark()
+{
+	// small meshes are where the per member overhead shows, big ones are dominated by the array copies
+	Array<Mesh> meshes(4096);
+	for (Mesh& mesh : meshes)
+		Mesh::CreateSphere(mesh, 1.0f, 4, 4);
+
+	Array<Skeleton> skeletons(256);
+	for (Skeleton& skeleton : skeletons)
+	{
+		skeleton.rootBone.name = "Root";
+		for (uint32_t i = 0; i < 64; i++)
+			skeleton.rootBone.children.push_back(Skeleton::Bone { .index = i, .name = std::format("Bone {}", i) });
+	}
+
+	Array<Animation> animations(64);
+	for (Animation& animation : animations)
+	{
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			KeyFrames keyframes;
+			keyframes.AddPositionKey(Vec3Key(0.0, Vec3(float(i))));
+			keyframes.AddRotationKey(QuatKey(0.0, Quat(1.0f, 0.0f, 0.0f, 0.0f)));
+			animation.LoadKeyframes(std::format("Bone {}", i), keyframes);
+		}
+	}
+
+	// reference: the reflective path, one virtual call per member. Nested types (bones, keyframes) always
+	// go through their own serializer, so this only measures the top level dispatch of each component.
+	const auto WriteReflected = [](ByteBuffer& ioBuffer, const auto& inObjects)
+	{
+		for (const auto& object : inObjects)
+		{
+			for (const auto& member : RTTI_OF<std::decay_t<decltype(object)>>())
+			{
+				if (member->GetSerializeType() & SERIALIZE_BINARY)
+					member->ToBinary(ioBuffer, &object);
+			}
+		}
+	};
+
+	const auto WriteSerializer = [](ByteBuffer& ioBuffer, const auto& inObjects)
+	{
+		for (const auto& object : inObjects)
+			WriteFileBinary(ioBuffer, object);
+	};
+
+	const auto Benchmark = [&](const char* inName, const auto& inObjects)
+	{
+		ByteBuffer reflected, serialized;
+
+		Timer timer;
+		WriteReflected(reflected, inObjects);
+		const float reflected_time = Timer::sToMilliseconds(timer.Restart());
+
+		WriteSerializer(serialized, inObjects);
+		const float serialized_time = Timer::sToMilliseconds(timer.Restart());
+
+		// both paths have to produce the exact same bytes
+		assert(reflected.GetData() == serialized.GetData());
+
+		serialized.Seek(0);
+		for (uint32_t i = 0; i < inObjects.size(); i++)
+		{
+			std::decay_t<decltype(inObjects[0])> object;
+			ReadFileBinary(serialized, object);
+		}
+
+		const float read_time = Timer::sToMilliseconds(timer.Restart());
+
+		std::cout << std::format("[Serialization] Benchmark {} x {} ({} KB): reflective write {:.2f} ms, serializer write {:.2f} ms, serializer read {:.2f} ms.\n",
+			inObjects.size(), inName, serialized.GetData().size() / 1024, reflected_time, serialized_time, read_time);
+	};
+
+	Benchmark("Mesh", meshes);
+	Benchmark("Skeleton", skeletons);
+	Benchmark("Animation", animations);
+}
+
+
 } // raekor
\ No newline at end of file
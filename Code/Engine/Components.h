@@ -72,6 +72,7 @@ struct DirectionalLight
 
 	String cubeMapFile;
 	uint32_t cubeMap = 0;
+	SharedPtr<TextureAsset> cubeMapAsset; // keeps the uploaded cube map referenced so Assets never evicts it, not serialized
 
 	Vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f };
 	Vec4 direction = { 0.25f, -0.9f, 0.0f, 0.0f };
@@ -101,31 +102,39 @@ struct Light
 };
 
 
-struct MeshletTriangle
-{
-	uint32_t mX : 10;
-	uint32_t mY : 10;
-	uint32_t mZ : 10;
-	uint32_t mW : 2;
-};
-
-
 struct Meshlet
 {
-	/* offsets within meshlet_vertices and meshlet_triangles arrays with meshlet data */
+	RTTI_DECLARE_TYPE(Meshlet);
+
+	/* offsets within Mesh::meshletIndices and Mesh::meshletTriangles */
 	uint32_t mVertexOffset;
 	uint32_t mTriangleOffset;
 
 	/* number of vertices and triangles used in the meshlet; data is stored in consecutive range defined by offset and count */
 	uint32_t mVertexCount;
 	uint32_t mTriangleCount;
+
+	/* bounding sphere and normal cone in object space, a meshlet can be backface culled if dot(normalize(mConeApex - camera), mConeAxis) >= mConeCutoff */
+	Vec3 mCenter;
+	float mRadius;
+	Vec3 mConeApex;
+	Vec3 mConeAxis;
+	float mConeCutoff;
 };
 
 
+struct Skeleton;
+
 struct Mesh
 {
 	RTTI_DECLARE_TYPE(Mesh);
 
+	static constexpr uint32_t sVertexCacheSize = 16; // FIFO size AnalyzeVertexCache simulates
+	static constexpr uint32_t sOptimizerVersion = 1; // bump when Optimize changes its output
+	static constexpr uint32_t sMeshletVersion = 1; // bump when CalculateMeshlets changes its output
+	static constexpr uint32_t sMeshletMaxVertices = 64;
+	static constexpr uint32_t sMeshletMaxTriangles = 124;
+
 	String name;
 	BBox3D bbox;
 	float lodFade = 0.0f;
@@ -140,8 +149,8 @@ struct Mesh
 	Array<float> vertices; // OPTIMIZE ME
 
 	Array<Meshlet> meshlets;
-	Array<uint32_t> meshletIndices;
-	Array<MeshletTriangle> meshletTriangles;
+	Array<uint32_t> meshletIndices; // into the vertex buffer
+	Array<uint32_t> meshletTriangles; // 3x 10 bit indices into the meshlet's range of meshletIndices
 
 	uint32_t vertexBuffer = 0;
 	uint32_t indexBuffer = 0;
@@ -156,10 +165,23 @@ struct Mesh
 	void CalculateVertices();
 	void CalculateBoundingBox();
 
+	/* Splits the mesh into meshlets of at most sMeshletMaxVertices and sMeshletMaxTriangles and computes their culling bounds.
+		Done by the asset compiler so it's stored with the mesh, loading a scene doesn't build anything. */
+	void CalculateMeshlets();
+
+	/* Reorders indices for the post-transform vertex cache and then for less overdraw, and vertices in the order they're first
+		referenced. Every vertex attribute, including ioSkeleton's weights and indices, is remapped the same way and unreferenced vertices are dropped. */
+	void Optimize(Skeleton* ioSkeleton = nullptr);
+
+	/* Simulates the post-transform vertex cache over indices, gives ACMR (vertices transformed per triangle) and ATVR (per vertex). */
+	meshopt_VertexCacheStatistics AnalyzeVertexCache() const;
+
 	uint32_t GetVertexStride() const;
 
 	bool IsLoaded() const { return vertexBuffer != 0 && indexBuffer != 0 && BottomLevelAS != 0; }
 
+	RTTI_DECLARE_SERIALIZER(&Mesh::bbox, &Mesh::positions, &Mesh::uvs, &Mesh::normals, &Mesh::tangents, &Mesh::vertices, &Mesh::indices, &Mesh::material,
+		&Mesh::meshlets, &Mesh::meshletIndices, &Mesh::meshletTriangles);
 };
 
 
@@ -232,6 +254,8 @@ struct Skeleton
 		uint32_t index;
 		String name;
 		Array<Bone> children;
+
+		RTTI_DECLARE_SERIALIZER(&Bone::index, &Bone::name, &Bone::children);
 	};
 	
 	Bone rootBone;
@@ -254,6 +278,8 @@ struct Skeleton
 
 	void UpdateFromAnimation(const Animation& animation);
 	void UpdateBoneTransform(const Animation& inAnimation, Bone& inBone, const Mat4x4& inTransform);
+
+	RTTI_DECLARE_SERIALIZER(&Skeleton::animation, &Skeleton::inverseGlobalTransform, &Skeleton::boneWeights, &Skeleton::boneIndices, &Skeleton::boneOffsetMatrices, &Skeleton::rootBone);
 };
 
 
@@ -293,6 +319,13 @@ struct Material
 	uint8_t gpuMetallicMapSwizzle = TEXTURE_SWIZZLE_BBBB; // assume GLTF by default, TODO: make changes in FbxImporter?
 	uint8_t gpuRoughnessMapSwizzle = TEXTURE_SWIZZLE_GGGG; // assume GLTF by default, TODO: make changes in FbxImporter?
 
+	// keeps the uploaded textures referenced so Assets never evicts them while the material is alive, not serialized
+	SharedPtr<TextureAsset> albedoAsset;
+	SharedPtr<TextureAsset> normalAsset;
+	SharedPtr<TextureAsset> emissiveAsset;
+	SharedPtr<TextureAsset> metallicAsset;
+	SharedPtr<TextureAsset> roughnessAsset;
+
 	bool IsLoaded() const { return gpuAlbedoMap != 0 && gpuNormalMap != 0 && gpuMetallicMap != 0 && gpuRoughnessMap != 0 && gpuEmissiveMap != 0; }
 
 	// default material for newly spawned meshes
@@ -308,6 +341,9 @@ struct NativeScript
 	String type;
 	Array<String> types;
 	INativeScript* script = nullptr;
+
+	// keeps the DLL loaded so Assets never evicts (and unloads) it while the script's code can still run, not serialized
+	SharedPtr<ScriptAsset> asset;
 };
 
 
@@ -362,4 +398,6 @@ static constexpr auto Components = std::make_tuple(
 
 void gRegisterComponentTypes();
 
+void RunComponentSerializationBenchmark();
+
 } // Raekor
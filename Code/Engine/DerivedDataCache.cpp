@@ -0,0 +1,102 @@
+#include "PCH.h"
+#include "DerivedDataCache.h"
+#include "CVars.h"
+#include "Hash.h"
+
+namespace RK {
+
+DerivedDataCache::DerivedDataCache()
+{
+	m_Directory = g_CVariables ? g_CVariables->Create("ddc_path", String("Cached/DDC")) : "Cached/DDC";
+}
+
+
+DerivedDataCache::Key DerivedDataCache::sMakeKey(uint64_t inSourceHash, StringView inConverter, uint32_t inConverterVersion, uint64_t inSettingsHash)
+{
+	const StaticArray<uint64_t, 4> key_data = { inSourceHash, gHashFNV1a(inConverter.data(), inConverter.size()), inConverterVersion, inSettingsHash };
+	return gHashFNV1a((const char*)key_data.data(), sizeof(key_data));
+}
+
+
+Path DerivedDataCache::GetEntryPath(Key inKey) const
+{
+	// fan out over 256 directories so none of them end up with tens of thousands of files
+	const String name = std::format("{:016x}", inKey);
+	return m_Directory / name.substr(0, 2) / name;
+}
+
+
+bool DerivedDataCache::Contains(Key inKey) const
+{
+	std::error_code error_code;
+	return fs::is_regular_file(GetEntryPath(inKey), error_code);
+}
+
+
+bool DerivedDataCache::Fetch(Key inKey, const Path& outFile) const
+{
+	std::error_code error_code;
+
+	const Path entry_path = GetEntryPath(inKey);
+	if (!fs::is_regular_file(entry_path, error_code))
+		return false;
+
+	fs::create_directories(outFile.parent_path(), error_code);
+	return fs::copy_file(entry_path, outFile, fs::copy_options::overwrite_existing, error_code);
+}
+
+
+bool DerivedDataCache::Store(Key inKey, const Path& inFile) const
+{
+	std::error_code error_code;
+
+	if (!fs::is_regular_file(inFile, error_code))
+		return false;
+
+	const Path entry_path = GetEntryPath(inKey);
+	if (fs::is_regular_file(entry_path, error_code))
+		return true;
+
+	fs::create_directories(entry_path.parent_path(), error_code);
+
+	// unique per store, concurrent stores of the same key race on the rename which is fine as their content is identical
+	Path temp_path = entry_path;
+	temp_path += std::format(".{:08x}.tmp", std::random_device()());
+
+	if (!fs::copy_file(inFile, temp_path, fs::copy_options::overwrite_existing, error_code))
+		return false;
+
+	fs::rename(temp_path, entry_path, error_code);
+
+	if (error_code)
+	{
+		fs::remove(temp_path, error_code);
+		return fs::is_regular_file(entry_path, error_code);
+	}
+
+	return true;
+}
+
+
+DerivedDataCache::Key DerivedDataCache::sReadStamp(const Path& inCachedFile)
+{
+	std::ifstream stamp_file(sGetStampPath(inCachedFile));
+	if (!stamp_file.is_open())
+		return 0;
+
+	String stamp;
+	stamp_file >> stamp;
+
+	Key key = 0;
+	std::from_chars(stamp.data(), stamp.data() + stamp.size(), key, 16);
+	return key;
+}
+
+
+void DerivedDataCache::sWriteStamp(const Path& inCachedFile, Key inKey)
+{
+	std::ofstream stamp_file(sGetStampPath(inCachedFile));
+	stamp_file << std::format("{:016x}", inKey);
+}
+
+} // namespace RK
@@ -0,0 +1,40 @@
+#pragma once
+
+namespace RK {
+
+/* Content addressed store for converter output. Entries are keyed by a hash of the source content, the converter version
+	and its settings, so identical sources share an entry and touching a file without changing it never triggers a rebuild.
+	The directory comes from the ddc_path cvar (Cached/DDC by default), point multiple checkouts at the same one to share results. */
+class DerivedDataCache
+{
+public:
+	using Key = uint64_t;
+
+	DerivedDataCache();
+	DerivedDataCache(const Path& inDirectory) : m_Directory(inDirectory) {}
+
+	static Key sMakeKey(uint64_t inSourceHash, StringView inConverter, uint32_t inConverterVersion, uint64_t inSettingsHash = 0);
+
+	const Path& GetDirectory() const { return m_Directory; }
+	Path GetEntryPath(Key inKey) const;
+
+	bool Contains(Key inKey) const;
+
+	/* Copies the entry for inKey to outFile, returns false on a cache miss. */
+	bool Fetch(Key inKey, const Path& outFile) const;
+
+	/* Stores inFile under inKey. Writes to a temporary file first and renames it into place, so other
+		processes sharing the directory never see a partial entry. */
+	bool Store(Key inKey, const Path& inFile) const;
+
+	/* Every file the compiler writes gets a small stamp next to it with the key that produced it,
+		a file is up to date if its stamp matches the key of its current source. */
+	static Key sReadStamp(const Path& inCachedFile);
+	static void sWriteStamp(const Path& inCachedFile, Key inKey);
+	static Path sGetStampPath(const Path& inCachedFile) { Path stamp_path = inCachedFile; return stamp_path += ".ddc"; }
+
+private:
+	Path m_Directory;
+};
+
+} // namespace RK
@@ -100,6 +100,45 @@ void RunECStorageTests()
 
 	int new_count = ecs.Count<TestMaterial>();
 	assert(new_count == count);
+
+	// const access and GetUntracked leave the storage version alone, any other mutable access bumps it
+	const ECStorage& const_ecs = ecs;
+	uint64_t version = ecs.GetComponentStorage<TestMaterial>()->GetVersion();
+
+	for (const auto& [entity, material] : const_ecs.Each<TestMaterial>())
+		assert(const_ecs.Get<TestMaterial>(entity).color == material.color);
+
+	for (const auto& [entity, material, transform] : const_ecs.Each<TestMaterial, TestTransform>())
+		assert(const_ecs.GetPtr<TestMaterial>(entity) != nullptr);
+
+	assert(const_ecs.GetPtr<TestMaterial>(entities[0]) != nullptr);
+	ecs.GetUntracked<TestMaterial>(entities[0]);
+	assert(ecs.GetComponentStorage<TestMaterial>()->GetVersion() == version);
+
+	ecs.Get<TestMaterial>(entities[0]).color = Vec4(1.0f);
+	assert(ecs.GetComponentStorage<TestMaterial>()->GetVersion() != version);
+
+	version = ecs.GetComponentStorage<TestMaterial>()->GetVersion();
+	for (const auto& [entity, material] : ecs.Each<TestMaterial>())
+		material.color = Vec4(0.5f);
+	assert(ecs.GetComponentStorage<TestMaterial>()->GetVersion() != version);
+
+	version = ecs.GetComponentStorage<TestMaterial>()->GetVersion();
+	ecs.GetPtr<TestMaterial>(entities[0])->color = Vec4(1.0f);
+	assert(ecs.GetComponentStorage<TestMaterial>()->GetVersion() != version);
+
+	version = ecs.GetComponentStorage<TestMaterial>()->GetVersion();
+	ecs.GetMutable<TestMaterial>(entities[0]).color = Vec4(1.0f);
+	assert(ecs.GetComponentStorage<TestMaterial>()->GetVersion() != version);
+
+	version = ecs.GetComponentStorage<TestMaterial>()->GetVersion();
+	ecs.MarkDirty<TestMaterial>();
+	assert(ecs.GetComponentStorage<TestMaterial>()->GetVersion() != version);
+
+	IComponentStorage* clone = ecs.GetComponentStorage<TestMaterial>()->Clone();
+	assert(clone->Length() == ecs.Count<TestMaterial>());
+	assert(clone->GetVersion() == ecs.GetComponentStorage<TestMaterial>()->GetVersion());
+	delete clone;
 }
 
 } // namespace RK
@@ -29,6 +29,9 @@ public:
 	virtual bool    Contains(Entity inEntity) const = 0;
 	virtual void	Copy(Entity inFrom, Entity inTo) = 0;
 
+	/* Returns a deep copy of the storage, used to snapshot components for background work. */
+	virtual IComponentStorage* Clone() const = 0;
+
 	virtual void    Read(BinaryReadArchive& inArchive) = 0;
 	virtual void    Read(JSON::ReadArchive& inArchive) = 0;
 	virtual void	Read(Entity inEntity, BinaryReadArchive& inArchive) = 0;
@@ -41,12 +44,19 @@ public:
 
 	bool IsEmpty() const { return Length() == 0; }
 
+	/* Bumped on add/remove/read and on anything that hands out mutable access, so a matching version means the storage is unchanged.
+	   Code that only reads (e.g. per frame walks) should go through const access so it doesn't force the table into the next save. */
+	uint64_t GetVersion() const { return m_Version; }
+	void MarkDirty() { m_Version++; }
+
 	template<typename T> 
     ComponentStorage<T>* GetDerived() { return static_cast<ComponentStorage<T>*>( this ); }
 
 	template<typename T> 
     ComponentStorage<T>* GetDerived() const { return static_cast<ComponentStorage<T>*>( this ); }
 
+protected:
+	uint64_t m_Version = 0;
 };
 
 template<typename T>
@@ -161,9 +171,11 @@ public:
 
 	T& Insert(Entity entity, const T& t)
 	{
+		m_Version++;
+
 		if (Contains(entity))
 		{
-			T& existing_t = Get(entity);
+			T& existing_t = m_Components[m_Sparse[entity]];
 			existing_t = t;
 			return existing_t;
 		}
@@ -183,6 +195,14 @@ public:
 	}
 
 	T& Get(Entity entity)
+	{
+		m_Version++;
+		return m_Components[m_Sparse[entity]];
+	}
+
+	T& GetMutable(Entity entity) { return Get(entity); }
+
+	T& GetUntracked(Entity entity)
 	{
 		return m_Components[m_Sparse[entity]];
 	}
@@ -202,10 +222,15 @@ public:
 
 	void Copy(Entity inFrom, Entity inTo) override final
 	{
-		T component = Get(inFrom);
+		T component = std::as_const(*this).Get(inFrom);
 		Insert(inTo, component);
 	}
 
+	IComponentStorage* Clone() const override final
+	{
+		return new ComponentStorage<T>(*this);
+	}
+
 	void Add(Entity inEntity) override final
 	{
 		Insert(inEntity, T {});
@@ -216,6 +241,8 @@ public:
 		if (!Contains(entity))
 			return;
 
+		m_Version++;
+
 		// set the current component to whatever is in the back of the m_Components
 		m_Components[m_Sparse[entity]] = m_Components.back();
 		// set the current entity (packed) to whatever is in the back of the packed m_Entities
@@ -239,6 +266,7 @@ public:
 
 	void Clear() override final
 	{
+		m_Version++;
 		m_Sparse.clear();
 		m_Entities.clear();
 		m_Components.clear();
@@ -248,11 +276,14 @@ public:
 
 	void Read(BinaryReadArchive& ioArchive) override final
 	{
-		ReadFileBinary(ioArchive.GetFile(), m_Entities);
-		ReadFileBinary(ioArchive.GetFile(), m_Sparse);
+		m_Version++;
+		ioArchive.ResetTypeTable();
+
+		ReadFileBinary(ioArchive.GetBuffer(), m_Entities);
+		ReadFileBinary(ioArchive.GetBuffer(), m_Sparse);
 
 		size_t storage_size = 0ull;
-		ReadFileBinary(ioArchive.GetFile(), storage_size);
+		ReadFileBinary(ioArchive.GetBuffer(), storage_size);
 		m_Components.resize(storage_size);
 
 		for (T& component : m_Components)
@@ -265,7 +296,7 @@ public:
 		if (!Contains(inEntity))
 			return;
 
-		ioArchive >> Get(inEntity);
+		ioArchive >> GetMutable(inEntity);
 	}
 
 	void Read(Entity inEntity, JSON::ReadArchive& ioArchive) override final
@@ -273,15 +304,18 @@ public:
 		if (!Contains(inEntity))
 			return;
 
-		ioArchive >> Get(inEntity);
+		ioArchive >> GetMutable(inEntity);
 	}
 
 	void Write(BinaryWriteArchive& ioArchive) override final
 	{
-		WriteFileBinary(ioArchive.GetFile(), m_Entities);
-		WriteFileBinary(ioArchive.GetFile(), m_Sparse);
+		// every table can be read back on its own
+		ioArchive.ResetTypeTable();
+
+		WriteFileBinary(ioArchive.GetBuffer(), m_Entities);
+		WriteFileBinary(ioArchive.GetBuffer(), m_Sparse);
 
-		WriteFileBinary(ioArchive.GetFile(), m_Components.size());
+		WriteFileBinary(ioArchive.GetBuffer(), m_Components.size());
 
 		for (const T& component : m_Components)
 			ioArchive << component;
@@ -292,7 +326,7 @@ public:
 		if (!Contains(inEntity))
 			return;
 
-		ioArchive << Get(inEntity);
+		ioArchive << std::as_const(*this).Get(inEntity);
 	}
 
 	void Write(Entity inEntity, JSON::WriteArchive& ioArchive) override final
@@ -300,18 +334,18 @@ public:
 		if (!Contains(inEntity))
 			return;
 
-		ioArchive << Get(inEntity);
+		ioArchive << std::as_const(*this).Get(inEntity);
 	}
 
 	void Write(JSON::WriteArchive& ioArchive) override final {}
 
-	View Each() { return View(*this); }
+	View Each() { m_Version++; return View(*this); }
 	ConstView Each() const { return ConstView(*this); }
 
 	const Array<T>& GetComponents() const { return m_Components; }
 	const Array<Entity>& GetEntities() const { return m_Entities; }
 
-	auto begin() { return EachIterator(m_Components.begin(), m_Entities.begin()); }
+	auto begin() { m_Version++; return EachIterator(m_Components.begin(), m_Entities.begin()); }
 	auto end() { return EachIterator(m_Components.end(), m_Entities.end()); }
 
 	Array<T> m_Components;
@@ -324,6 +358,16 @@ public:
 class ECStorage
 {
 public:
+	ECStorage() = default;
+	ECStorage(const ECStorage&) = delete;
+	ECStorage& operator=(const ECStorage&) = delete;
+
+	~ECStorage()
+	{
+		for (IComponentStorage* components : std::views::values(m_Components))
+			delete components;
+	}
+
 	template<typename Component>
 	ComponentStorage<Component>* GetComponentStorage()
 	{
@@ -444,6 +488,27 @@ public:
 			return nullptr;
 	}
 
+	/* Same as Get, spelled out where a component is edited in place. */
+	template<typename Component>
+	Component& GetMutable(Entity inEntity)
+	{
+		return GetComponentStorage<Component>()->GetMutable(inEntity);
+	}
+
+	/* Mutable access that leaves the storage version alone, only for code that reports its own edits through MarkDirty.
+	   The inspector draws every component of the selected entity each frame but rarely changes one. */
+	template<typename Component>
+	Component& GetUntracked(Entity inEntity)
+	{
+		return GetComponentStorage<Component>()->GetUntracked(inEntity);
+	}
+
+	template<typename Component>
+	void MarkDirty()
+	{
+		GetComponentStorage<Component>()->MarkDirty();
+	}
+
 	template<typename Component>
 	const Array<Component>& GetStorage() const
 	{
@@ -470,6 +535,13 @@ public:
 		m_Entities.clear();
 	}
 
+	/* Swaps all entities and component storages with ioOther. Both should have the same component types registered. */
+	void Swap(ECStorage& ioOther)
+	{
+		std::swap(m_Entities, ioOther.m_Entities);
+		std::swap(m_Components, ioOther.m_Components);
+	}
+
 	template<typename ...Components>
 	bool Has(Entity inEntity) const
 	{
@@ -241,7 +241,10 @@ void FBXImporter::ConvertMesh(Entity inEntity, const ufbx_mesh* inMesh, const uf
 		mesh.CalculateVertices();
 
 	if (m_Renderer)
+	{
+		ProcessMesh(mesh, inMesh->skin_deformers.count > 0);
 		m_Renderer->UploadMeshBuffers(inEntity, mesh);
+	}
 }
 
 
@@ -0,0 +1,350 @@
+#include "PCH.h"
+#include "FileWatcher.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+namespace RK {
+
+FileWatcher::FileWatcher(const Path& inDirectory, std::chrono::milliseconds inSettleTime) :
+	m_Directory(inDirectory),
+	m_SettleTime(inSettleTime)
+{
+	std::error_code error_code;
+	if (!fs::is_directory(inDirectory, error_code))
+	{
+		std::cout << std::format("[FileWatcher] {} is not a directory.\n", inDirectory.string());
+		return;
+	}
+
+	m_Thread = std::thread(&FileWatcher::ThreadLoop, this);
+}
+
+
+FileWatcher::~FileWatcher()
+{
+	m_Quit = true;
+
+	if (m_Thread.joinable())
+		m_Thread.join();
+}
+
+
+Array<FileChange> FileWatcher::PollChanges()
+{
+	Array<FileChange> changes;
+
+	const Clock::time_point now = Clock::now();
+
+	std::scoped_lock lock(m_Mutex);
+
+	for (auto pending = m_Pending.begin(); pending != m_Pending.end();)
+	{
+		if (now - pending->second.time < m_SettleTime)
+		{
+			pending++;
+			continue;
+		}
+
+		changes.push_back(FileChange { .path = pending->first, .change = pending->second.change });
+		pending = m_Pending.erase(pending);
+	}
+
+	return changes;
+}
+
+
+void FileWatcher::AddChange(const Path& inPath, EFileChange inChange)
+{
+	std::scoped_lock lock(m_Mutex);
+
+	auto [pending, inserted] = m_Pending.try_emplace(inPath, PendingChange { .change = inChange });
+
+	// writes to a file that was just created are still part of creating it
+	if (!inserted && !( pending->second.change == FILE_CHANGE_ADDED && inChange == FILE_CHANGE_MODIFIED ))
+		pending->second.change = inChange;
+
+	pending->second.time = Clock::now();
+}
+
+
+#if defined(_WIN32)
+
+void FileWatcher::ThreadLoop()
+{
+	HANDLE directory = CreateFileW(m_Directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+	if (directory == INVALID_HANDLE_VALUE)
+	{
+		std::cout << std::format("[FileWatcher] Failed to open {}.\n", m_Directory.string());
+		return;
+	}
+
+	OVERLAPPED overlapped = {};
+	overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+	Array<uint8_t> buffer(64 * 1024);
+
+	const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+	m_Watching = true;
+
+	while (!m_Quit)
+	{
+		ResetEvent(overlapped.hEvent);
+
+		if (!ReadDirectoryChangesW(directory, buffer.data(), DWORD(buffer.size()), TRUE, filter, nullptr, &overlapped, nullptr))
+			break;
+
+		// wake up regularly to check if we should quit
+		DWORD wait_result = WAIT_TIMEOUT;
+		while (!m_Quit && ( wait_result = WaitForSingleObject(overlapped.hEvent, 100) ) == WAIT_TIMEOUT) {}
+
+		DWORD bytes = 0;
+
+		if (wait_result != WAIT_OBJECT_0)
+		{
+			// the read is still pending and the kernel writes to buffer and overlapped until it completes, wait for the cancel to go through before tearing them down
+			CancelIoEx(directory, &overlapped);
+			GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+			break;
+		}
+
+		if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE))
+			break;
+
+		// the buffer overflowed, we don't know what changed so report the whole directory
+		if (bytes == 0)
+		{
+			AddChange(m_Directory, FILE_CHANGE_MODIFIED);
+			continue;
+		}
+
+		for (uint8_t* data = buffer.data();;)
+		{
+			const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)data;
+			const Path path = m_Directory / WString(info->FileName, info->FileNameLength / sizeof(WCHAR));
+
+			switch (info->Action)
+			{
+				case FILE_ACTION_ADDED:
+				case FILE_ACTION_RENAMED_NEW_NAME:
+					AddChange(path, FILE_CHANGE_ADDED);
+					break;
+
+				case FILE_ACTION_REMOVED:
+				case FILE_ACTION_RENAMED_OLD_NAME:
+					AddChange(path, FILE_CHANGE_REMOVED);
+					break;
+
+				default:
+					AddChange(path, FILE_CHANGE_MODIFIED);
+					break;
+			}
+
+			if (info->NextEntryOffset == 0)
+				break;
+
+			data += info->NextEntryOffset;
+		}
+	}
+
+	m_Watching = false;
+
+	CloseHandle(overlapped.hEvent);
+	CloseHandle(directory);
+}
+
+#elif defined(__linux__)
+
+void FileWatcher::ThreadLoop()
+{
+	const int inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify < 0)
+	{
+		std::cout << std::format("[FileWatcher] Failed to initialize inotify for {}.\n", m_Directory.string());
+		return;
+	}
+
+	// inotify isn't recursive, every directory needs its own watch
+	HashMap<int, Path> watches;
+
+	const auto WatchDirectory = [&](const Path& inDirectory)
+	{
+		const uint32_t mask = IN_CREATE | IN_CLOSE_WRITE | IN_MODIFY | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+		if (int watch = inotify_add_watch(inotify, inDirectory.c_str(), mask); watch >= 0)
+			watches[watch] = inDirectory;
+
+		std::error_code error_code;
+		for (const fs::directory_entry& entry : fs::recursive_directory_iterator(inDirectory, error_code))
+		{
+			if (!entry.is_directory())
+				continue;
+
+			if (int watch = inotify_add_watch(inotify, entry.path().c_str(), mask); watch >= 0)
+				watches[watch] = entry.path();
+		}
+	};
+
+	// a moved directory keeps its watches but not its path, drop them so events from outside the tree don't get reported under the old one
+	const auto UnwatchDirectory = [&](const Path& inDirectory)
+	{
+		for (auto watch = watches.begin(); watch != watches.end();)
+		{
+			const Path relative_path = watch->second.lexically_relative(inDirectory);
+
+			if (relative_path.empty() || *relative_path.begin() == "..")
+			{
+				watch++;
+				continue;
+			}
+
+			inotify_rm_watch(inotify, watch->first);
+			watch = watches.erase(watch);
+		}
+	};
+
+	WatchDirectory(m_Directory);
+
+	alignas(inotify_event) StaticArray<uint8_t, 64 * 1024> buffer;
+
+	m_Watching = true;
+
+	while (!m_Quit)
+	{
+		pollfd poll_fd = { .fd = inotify, .events = POLLIN };
+
+		// wake up regularly to check if we should quit
+		if (poll(&poll_fd, 1, 100) <= 0)
+			continue;
+
+		const ssize_t bytes = read(inotify, buffer.data(), buffer.size());
+		if (bytes <= 0)
+			continue;
+
+		for (ssize_t offset = 0; offset < bytes;)
+		{
+			const inotify_event* event = (const inotify_event*)( buffer.data() + offset );
+			offset += sizeof(inotify_event) + event->len;
+
+			// the kernel queue overflowed, we don't know what changed so report the whole directory
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				AddChange(m_Directory, FILE_CHANGE_MODIFIED);
+				continue;
+			}
+
+			// the watch is gone, its directory was deleted (or unwatched by us)
+			if (event->mask & IN_IGNORED)
+			{
+				watches.erase(event->wd);
+				continue;
+			}
+
+			auto watch = watches.find(event->wd);
+			if (watch == watches.end() || event->len == 0)
+				continue;
+
+			const Path path = watch->second / event->name;
+
+			if (event->mask & IN_ISDIR)
+			{
+				// files can land in a new directory before we get to watch it, report those by scanning it
+				if (event->mask & ( IN_CREATE | IN_MOVED_TO ))
+				{
+					WatchDirectory(path);
+
+					std::error_code error_code;
+					for (const fs::directory_entry& entry : fs::recursive_directory_iterator(path, error_code))
+					{
+						if (entry.is_regular_file())
+							AddChange(entry.path(), FILE_CHANGE_ADDED);
+					}
+				}
+				else if (event->mask & ( IN_DELETE | IN_MOVED_FROM ))
+				{
+					UnwatchDirectory(path);
+				}
+
+				continue;
+			}
+
+			if (event->mask & ( IN_CREATE | IN_MOVED_TO ))
+				AddChange(path, FILE_CHANGE_ADDED);
+			else if (event->mask & ( IN_DELETE | IN_MOVED_FROM ))
+				AddChange(path, FILE_CHANGE_REMOVED);
+			else
+				AddChange(path, FILE_CHANGE_MODIFIED);
+		}
+	}
+
+	m_Watching = false;
+
+	close(inotify);
+}
+
+#else
+
+void FileWatcher::ThreadLoop()
+{
+	// no native notifications, compare write times every half second
+	struct FileState
+	{
+		fs::file_time_type writeTime;
+		uintmax_t size;
+	};
+
+	const auto Scan = [this]()
+	{
+		HashMap<Path, FileState> files;
+
+		std::error_code error_code;
+		for (const fs::directory_entry& entry : fs::recursive_directory_iterator(m_Directory, error_code))
+		{
+			if (entry.is_regular_file())
+				files[entry.path()] = FileState { .writeTime = entry.last_write_time(error_code), .size = entry.file_size(error_code) };
+		}
+
+		return files;
+	};
+
+	HashMap<Path, FileState> files = Scan();
+
+	m_Watching = true;
+
+	while (!m_Quit)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+		HashMap<Path, FileState> new_files = Scan();
+
+		for (const auto& [path, state] : new_files)
+		{
+			auto file = files.find(path);
+
+			if (file == files.end())
+				AddChange(path, FILE_CHANGE_ADDED);
+			else if (file->second.writeTime != state.writeTime || file->second.size != state.size)
+				AddChange(path, FILE_CHANGE_MODIFIED);
+		}
+
+		for (const auto& [path, state] : files)
+		{
+			if (!new_files.contains(path))
+				AddChange(path, FILE_CHANGE_REMOVED);
+		}
+
+		files = std::move(new_files);
+	}
+
+	m_Watching = false;
+}
+
+#endif
+
+} // namespace RK
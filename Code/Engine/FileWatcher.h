@@ -0,0 +1,59 @@
+#pragma once
+
+namespace RK {
+
+enum EFileChange
+{
+	FILE_CHANGE_ADDED,
+	FILE_CHANGE_MODIFIED,
+	FILE_CHANGE_REMOVED
+};
+
+
+struct FileChange
+{
+	Path path; // inDirectory joined with the path relative to it
+	EFileChange change;
+};
+
+
+/* Watches a directory tree on a background thread using the OS's change notifications (ReadDirectoryChangesW on Windows,
+	inotify on Linux, stat polling elsewhere) and reports exactly which files changed. Bursts are coalesced: a file is only reported
+	once it's been quiet for inSettleTime, so an editor writing a file in several steps results in a single change. */
+class FileWatcher
+{
+public:
+	FileWatcher(const Path& inDirectory, std::chrono::milliseconds inSettleTime = std::chrono::milliseconds(100));
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	const Path& GetDirectory() const { return m_Directory; }
+	bool IsWatching() const { return m_Watching.load(); }
+
+	/* Returns the changes that settled since the last call, never blocks. Thread-safe. */
+	Array<FileChange> PollChanges();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void ThreadLoop();
+	void AddChange(const Path& inPath, EFileChange inChange);
+
+	struct PendingChange
+	{
+		EFileChange change;
+		Clock::time_point time;
+	};
+
+	Path m_Directory;
+	Clock::duration m_SettleTime;
+	Atomic<bool> m_Quit = false;
+	Atomic<bool> m_Watching = false;
+	Mutex m_Mutex;
+	HashMap<Path, PendingChange> m_Pending;
+	std::thread m_Thread;
+};
+
+} // namespace RK
@@ -36,6 +36,38 @@ bool handle_cgltf_error(cgltf_result result, const char* operation)
 }
 
 
+/* Buffer uri's are relative to the .gltf and percent-encoded, decoded the same way cgltf_load_buffers does it so the path matches the file it read. */
+static Path sGetBufferPath(const Path& inDirectory, const char* inUri)
+{
+	String uri = inUri;
+	uri.resize(cgltf_decode_uri(uri.data()));
+	return inDirectory / uri;
+}
+
+
+Array<String> GltfImporter::sGetFileDependencies(const String& inFile)
+{
+	Array<String> dependencies;
+
+	cgltf_options options = {};
+	cgltf_data* gltf_data = nullptr;
+
+	if (cgltf_parse_file(&options, inFile.c_str(), &gltf_data) != cgltf_result_success)
+		return dependencies;
+
+	const Path directory = Path(inFile).parent_path() / "";
+
+	for (const cgltf_buffer& buffer : Slice(gltf_data->buffers, gltf_data->buffers_count))
+	{
+		if (buffer.uri && strncmp(buffer.uri, "data:", 5) != 0)
+			dependencies.push_back(sGetBufferPath(directory, buffer.uri).lexically_normal().string());
+	}
+
+	cgltf_free(gltf_data);
+	return dependencies;
+}
+
+
 GltfImporter::~GltfImporter()
 {
 	if (m_GltfData)
@@ -59,6 +91,13 @@ bool GltfImporter::LoadFromFile(const String& inFile, Assets* inAssets)
 	if (!handle_cgltf_error(cgltf_load_buffers(&options, m_GltfData, inFile.c_str()), "Load"))
 		return false;
 
+	for (const cgltf_buffer& buffer : Slice(m_GltfData->buffers, m_GltfData->buffers_count))
+	{
+		// embedded buffers are base64 data uri's
+		if (buffer.uri && strncmp(buffer.uri, "data:", 5) != 0)
+			AddFileDependency(sGetBufferPath(m_Directory, buffer.uri));
+	}
+
 	if (!handle_cgltf_error(cgltf_validate(m_GltfData), "Validate"))
 		return false;
 
@@ -316,7 +355,12 @@ bool GltfImporter::ConvertMesh(Entity inEntity, const cgltf_primitive& inMesh)
 		mesh.CalculateVertices();
 
 	if (m_Renderer)
+	{
+		const auto IsJoints = [](const cgltf_attribute& inAttribute) { return inAttribute.type == cgltf_attribute_type_joints; };
+		ProcessMesh(mesh, std::any_of(inMesh.attributes, inMesh.attributes + inMesh.attributes_count, IsJoints));
+
 		m_Renderer->UploadMeshBuffers(inEntity, mesh);
+	}
 
 	return true;
 }
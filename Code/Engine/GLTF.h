@@ -19,6 +19,9 @@ public:
 
 	bool LoadFromFile(const String& inFile, Assets* inAssets) override;
 
+	/* The external buffers LoadFromFile would report through GetFileDependencies, only parses the json so it's cheap enough to call before converting. */
+	static Array<String> sGetFileDependencies(const String& inFile);
+
 private:
 	void ParseNode(const cgltf_node& gltfNode, Entity parent, glm::mat4 transform);
 
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
 
 namespace RK {
 
@@ -16,6 +20,17 @@ inline constexpr uint32_t gHash32Bit(const char* const str, const uint32_t value
 }
 
 
+inline constexpr uint32_t gHash32Bit(std::string_view inString) noexcept
+{
+    uint32_t value = val_32_const;
+
+    for (char c : inString)
+        value = ( value ^ uint32_t(c) ) * prime_32_const;
+
+    return value;
+}
+
+
 inline constexpr uint64_t gHash64Bit(const char* const str, const uint64_t value = val_64_const) noexcept
 {
     return ( str[0] == '\0' ) ? value : gHash64Bit(&str[1], ( value ^ uint64_t(str[0]) ) * prime_64_const);
@@ -32,4 +47,128 @@ inline uint64_t gHashFNV1a(const char* const inData, uint64_t inLength)
     return hash;
 }
 
+
+/* Streaming 64-bit xxHash (XXH64). Each 32 byte stripe is split over four independent lanes so the CPU can keep them
+    in flight at once, it runs close to memory bandwidth instead of one multiply per byte like FNV. Update can be
+    called with chunks of any size, the result only depends on the concatenated bytes. */
+class XXHash64
+{
+public:
+    XXHash64(uint64_t inSeed = 0) { Reset(inSeed); }
+
+    void Reset(uint64_t inSeed = 0)
+    {
+        m_Lanes[0] = inSeed + sPrime1 + sPrime2;
+        m_Lanes[1] = inSeed + sPrime2;
+        m_Lanes[2] = inSeed;
+        m_Lanes[3] = inSeed - sPrime1;
+        m_Seed = inSeed;
+        m_TotalLength = 0;
+        m_BufferSize = 0;
+    }
+
+    void Update(const void* inData, uint64_t inLength)
+    {
+        const uint8_t* data = (const uint8_t*)inData;
+        const uint8_t* end = data + inLength;
+
+        m_TotalLength += inLength;
+
+        // top up the leftovers from the previous call first
+        if (m_BufferSize)
+        {
+            const uint64_t count = std::min<uint64_t>(sStripeSize - m_BufferSize, inLength);
+            std::memcpy(m_Buffer + m_BufferSize, data, count);
+            m_BufferSize += uint32_t(count);
+            data += count;
+
+            if (m_BufferSize < sStripeSize)
+                return;
+
+            ConsumeStripe(m_Buffer);
+            m_BufferSize = 0;
+        }
+
+        for (; end - data >= sStripeSize; data += sStripeSize)
+            ConsumeStripe(data);
+
+        if (data < end)
+        {
+            m_BufferSize = uint32_t(end - data);
+            std::memcpy(m_Buffer, data, m_BufferSize);
+        }
+    }
+
+    uint64_t Digest() const
+    {
+        uint64_t hash = m_Seed + sPrime5;
+
+        if (m_TotalLength >= sStripeSize)
+        {
+            hash = std::rotl(m_Lanes[0], 1) + std::rotl(m_Lanes[1], 7) + std::rotl(m_Lanes[2], 12) + std::rotl(m_Lanes[3], 18);
+
+            for (uint64_t lane : m_Lanes)
+                hash = ( hash ^ sRound(0, lane) ) * sPrime1 + sPrime4;
+        }
+
+        hash += m_TotalLength;
+
+        const uint8_t* data = m_Buffer;
+        const uint8_t* end = m_Buffer + m_BufferSize;
+
+        for (; end - data >= 8; data += 8)
+            hash = std::rotl(hash ^ sRound(0, sRead64(data)), 27) * sPrime1 + sPrime4;
+
+        if (end - data >= 4)
+        {
+            hash = std::rotl(hash ^ ( sRead32(data) * sPrime1 ), 23) * sPrime2 + sPrime3;
+            data += 4;
+        }
+
+        for (; data < end; data++)
+            hash = std::rotl(hash ^ ( *data * sPrime5 ), 11) * sPrime1;
+
+        // avalanche
+        hash ^= hash >> 33;
+        hash *= sPrime2;
+        hash ^= hash >> 29;
+        hash *= sPrime3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+private:
+    static constexpr uint64_t sPrime1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t sPrime2 = 0xC2B2AE3D27D4EB4Full;
+    static constexpr uint64_t sPrime3 = 0x165667B19E3779F9ull;
+    static constexpr uint64_t sPrime4 = 0x85EBCA77C2B2AE63ull;
+    static constexpr uint64_t sPrime5 = 0x27D4EB2F165667C5ull;
+    static constexpr int64_t sStripeSize = 32;
+
+    static uint64_t sRead64(const uint8_t* inData) { uint64_t value; std::memcpy(&value, inData, sizeof(value)); return value; }
+    static uint64_t sRead32(const uint8_t* inData) { uint32_t value; std::memcpy(&value, inData, sizeof(value)); return value; }
+    static uint64_t sRound(uint64_t inLane, uint64_t inInput) { return std::rotl(inLane + inInput * sPrime2, 31) * sPrime1; }
+
+    void ConsumeStripe(const uint8_t* inData)
+    {
+        for (int lane = 0; lane < 4; lane++)
+            m_Lanes[lane] = sRound(m_Lanes[lane], sRead64(inData + lane * 8));
+    }
+
+    uint64_t m_Lanes[4];
+    uint64_t m_Seed;
+    uint64_t m_TotalLength;
+    uint8_t m_Buffer[sStripeSize];
+    uint32_t m_BufferSize;
+};
+
+
+inline uint64_t gHashXXH64(const void* inData, uint64_t inLength, uint64_t inSeed = 0)
+{
+    XXHash64 hasher(inSeed);
+    hasher.Update(inData, inLength);
+    return hasher.Digest();
+}
+
 } // raekor
\ No newline at end of file
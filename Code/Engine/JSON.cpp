@@ -1,50 +1,46 @@
 #include "pch.h"
 #include "json.h"
 #include "iter.h"
+#include "timer.h"
+#include "member.h"
 
 namespace RK::JSON {
 
-JSONData::JSONData(const Path& inPath, bool inTokenizeOnly)
+JSONData::JSONData(const Path& inPath)
 {
-	auto ifs = std::ifstream(inPath);
-	std::stringstream buffer;
-	buffer << ifs.rdbuf();
-	m_StrBuffer = buffer.str();
+	auto ifs = std::ifstream(inPath, std::ios::binary);
+	if (!ifs.is_open())
+		return;
+
+	std::error_code error_code;
+	m_StrBuffer.resize(fs::file_size(inPath, error_code));
+	ifs.read(m_StrBuffer.data(), m_StrBuffer.size());
+
+	Tokenize();
+}
 
+
+JSONData::JSONData(String&& inSource) : m_StrBuffer(std::move(inSource))
+{
+	Tokenize();
+}
+
+
+void JSONData::Tokenize()
+{
 	jsmn_parser parser;
 	jsmn_init(&parser);
 
 	const auto nr_of_tokens = jsmn_parse(&parser, m_StrBuffer.c_str(), m_StrBuffer.size(), NULL, 0);
-	if (nr_of_tokens == 0)
+	if (nr_of_tokens <= 0)
 		return;
 
 	jsmn_init(&parser);
 	m_Tokens.resize(nr_of_tokens);
 	const auto parse_result = jsmn_parse(&parser, m_StrBuffer.c_str(), m_StrBuffer.size(), m_Tokens.data(), m_Tokens.size());
 
-	if (parse_result != nr_of_tokens || inTokenizeOnly)
-		return;
-
-	m_Strings.resize(nr_of_tokens);
-	m_Primitives.resize(nr_of_tokens);
-
-	for (const auto& [index, token] : gEnumerate(m_Tokens))
-	{
-		auto c = m_StrBuffer[token.start];
-
-		if (token.type == JSMN_PRIMITIVE)
-		{
-			if (std::isdigit(c) || c == '.' || c == '-' || c == 'e')
-			{
-				std::from_chars(&m_StrBuffer[m_Tokens[index].start], &m_StrBuffer[m_Tokens[index].end], m_Primitives[index]);
-			}
-			else if (c == 't' || c == 'f')
-				m_Primitives[index] = 't' ? (double)true : (double)false;
-
-		}
-		else if (token.type == JSMN_STRING)
-			m_Strings[index] = std::string(&m_StrBuffer[token.start], token.end - token.start);
-	}
+	if (parse_result != nr_of_tokens)
+		m_Tokens.clear();
 }
 
 
@@ -72,4 +68,94 @@ uint32_t JSONData::SkipToken(uint32_t inTokenIdx) const
 	return inTokenIdx;
 }
 
+struct JSONBenchmarkEntity
+{
+	RTTI_DECLARE_TYPE(JSONBenchmarkEntity);
+
+	String name;
+	Vec3 position;
+	float intensity = 0.0f;
+	uint32_t flags = 0;
+	bool enabled = false;
+	Array<uint32_t> indices;
+};
+
+RTTI_DEFINE_TYPE(JSONBenchmarkEntity)
+{
+	RTTI_DEFINE_MEMBER(JSONBenchmarkEntity, SERIALIZE_ALL, "Name", name);
+	RTTI_DEFINE_MEMBER(JSONBenchmarkEntity, SERIALIZE_ALL, "Position", position);
+	RTTI_DEFINE_MEMBER(JSONBenchmarkEntity, SERIALIZE_ALL, "Intensity", intensity);
+	RTTI_DEFINE_MEMBER(JSONBenchmarkEntity, SERIALIZE_ALL, "Flags", flags);
+	RTTI_DEFINE_MEMBER(JSONBenchmarkEntity, SERIALIZE_ALL, "Enabled", enabled);
+	RTTI_DEFINE_MEMBER(JSONBenchmarkEntity, SERIALIZE_ALL, "Indices", indices);
+}
+
+
+void RunJSONBenchmark()
+{
+	constexpr uint32_t cEntityCount = 100'000;
+
+	// build a document shaped like a large scene export
+	Array<JSONBenchmarkEntity> entities(cEntityCount);
+
+	for (const auto& [index, entity] : gEnumerate(entities))
+	{
+		entity.name = std::format("Entity {}", index);
+		entity.position = Vec3(float(index), float(index) * 0.5f, -float(index));
+		entity.intensity = float(index) * 0.25f;
+		entity.flags = uint32_t(index);
+		entity.enabled = index % 2;
+		entity.indices = { uint32_t(index), uint32_t(index + 1), uint32_t(index + 2) };
+	}
+
+	JSONWriter writer;
+	writer.Write("{\n\"Entities\": ");
+	writer.GetValueToJSON(entities);
+	writer.Write("\n}");
+
+	const String source = writer.GetString();
+
+	Timer timer;
+
+	// reference: what JSONData used to do, materialize a string and a double for every token up front
+	{
+		jsmn_parser parser;
+		jsmn_init(&parser);
+
+		const int token_count = jsmn_parse(&parser, source.c_str(), source.size(), NULL, 0);
+		Array<jsmntok_t> tokens(token_count);
+
+		jsmn_init(&parser);
+		jsmn_parse(&parser, source.c_str(), source.size(), tokens.data(), tokens.size());
+
+		Array<String> strings(token_count);
+		Array<double> primitives(token_count);
+
+		for (const auto& [index, token] : gEnumerate(tokens))
+		{
+			if (token.type == JSMN_PRIMITIVE)
+				std::from_chars(&source[token.start], &source[token.end], primitives[index]);
+			else if (token.type == JSMN_STRING)
+				strings[index] = String(&source[token.start], token.end - token.start);
+		}
+	}
+
+	const float eager_time = Timer::sToMilliseconds(timer.Restart());
+
+	JSONData json = JSONData(String(source));
+	const float tokenize_time = Timer::sToMilliseconds(timer.Restart());
+
+	// token 0 is the root object, 1 the "Entities" key, 2 the array
+	Array<JSONBenchmarkEntity> parsed_entities;
+	json.GetTokenToValue(2, parsed_entities);
+
+	const float extract_time = Timer::sToMilliseconds(timer.Restart());
+
+	assert(parsed_entities.size() == entities.size());
+	assert(parsed_entities.back().name == entities.back().name && parsed_entities.back().flags == entities.back().flags);
+
+	std::cout << std::format("[JSON] Benchmark ({} entities, {:.2f} MB): eager tokenize + materialize {:.2f} ms, lazy tokenize {:.2f} ms, lazy extract all values {:.2f} ms.\n",
+		cEntityCount, source.size() / ( 1024.0f * 1024.0f ), eager_time, tokenize_time, extract_time);
+}
+
 } // raekor::JSON
\ No newline at end of file
@@ -6,11 +6,16 @@
 
 namespace RK::JSON {
 
+/*
+	Only tokenizes up front, strings are views into the source buffer and numbers are parsed with from_chars when a value is requested.
+	Strings are returned as-is, escape sequences are not resolved.
+*/
 class JSONData
 {
 public:
 	JSONData() = default;
-	JSONData(const Path& inPath, bool inTokenizeOnly = false);
+	JSONData(const Path& inPath);
+	JSONData(String&& inSource);
 
 	bool IsKeyObjectPair(uint32_t inTokenIdx) const;
 	uint32_t SkipToken(uint32_t inTokenIdx) const;
@@ -22,8 +27,12 @@ public:
 	bool HasRootObject() const { return m_Tokens.size() > 0 && m_Tokens[0].type == JSMN_OBJECT; }
 
 	const jsmntok_t& GetToken(uint32_t inTokenIdx) const { return m_Tokens[inTokenIdx]; }
-	const std::string& GetString(uint32_t inTokenIdx) const { return m_Strings[inTokenIdx]; }
-	double GetPrimitive(uint32_t inTokenIdx) const { return m_Primitives[inTokenIdx]; }
+	StringView GetString(uint32_t inTokenIdx) const { return StringView(m_StrBuffer).substr(m_Tokens[inTokenIdx].start, m_Tokens[inTokenIdx].end - m_Tokens[inTokenIdx].start); }
+	double GetPrimitive(uint32_t inTokenIdx) const { return GetNumber<double>(inTokenIdx); }
+
+	/* Parses a primitive token straight into T, true/false/null become 1/0/0. Integers that don't fit T are logged and read as 0. */
+	template<typename T>
+	T GetNumber(uint32_t inTokenIdx) const;
 
 public:
 	// Generics
@@ -64,50 +73,67 @@ public:
 	uint32_t GetTokenToValue(uint32_t inTokenIdx, std::variant<Types...>& inValue);
 
 private:
+	void Tokenize();
+
 	String m_StrBuffer;
 	Array<jsmntok_t> m_Tokens;
-	Array<double> m_Primitives;
-	Array<String> m_Strings;
 };
 
 
 
+/* Formats JSON into a growable char buffer. Numbers go through std::to_chars and
+   math types through gToChars on the stack, so nothing allocates per value.
+   Callers writing large documents should drain the buffer with GetView/Clear. */
 class JSONWriter
 {
 public:
-	template<typename T>
-	JSONWriter& IndentAndWrite(const T& inValue)
+	JSONWriter& IndentAndWrite(StringView inValue)
 	{
 		WriteIndent();
-		m_SS << inValue;
+		return Write(inValue);
+	}
+
+	JSONWriter& Write(StringView inValue)
+	{
+		m_Buffer.append(inValue);
 		return *this;
 	}
 
-	template<typename T>
-	JSONWriter& Write(const T& inValue)
+	JSONWriter& Write(char inValue)
+	{
+		m_Buffer.push_back(inValue);
+		return *this;
+	}
+
+	template<typename T> requires std::is_arithmetic_v<T>
+	JSONWriter& WriteNumber(T inValue)
 	{
-		m_SS << inValue;
+		char chars[64];
+		const auto [ptr, error] = std::to_chars(chars, chars + sizeof(chars), inValue);
+		m_Buffer.append(chars, ptr);
 		return *this;
 	}
 
 	JSONWriter& WriteIndent()
 	{
-		for (uint32_t i = 0; i < m_Indent; i++)
-			m_SS << "    ";
+		m_Buffer.append(m_Indent * 4, ' ');
 		return *this;
 	}
 
 	JSONWriter& PopIndent() { m_Indent--; return *this; }
 	JSONWriter& PushIndent() { m_Indent++; return *this; }
 
-	String GetString() const { return m_SS.str(); }
+	const String& GetString() const { return m_Buffer; }
+	StringView GetView() const { return m_Buffer; }
+	size_t GetSize() const { return m_Buffer.size(); }
 
-	void Clear() { m_SS = {}; }
+	// keeps the allocation around for the next object
+	void Clear() { m_Buffer.clear(); }
 
 	void WriteToFile(const Path& inPath)
 	{
 		auto ofs = std::ofstream(inPath);
-		ofs << GetString();
+		ofs.write(m_Buffer.data(), m_Buffer.size());
 	}
 
 public:
@@ -155,7 +181,7 @@ public:
 
 private:
 	int32_t m_Indent = 0;
-	std::stringstream m_SS;
+	String m_Buffer;
 };
 
 
@@ -172,10 +198,10 @@ inline uint32_t JSONData::GetTokenToValue(uint32_t inTokenIdx, T& inValue)
 
 	for (int key_index = 0; key_index < object_token.size; key_index++)
 	{
-		const String& key_string = GetString(inTokenIdx); // member name
+		const StringView key_string = GetString(inTokenIdx); // member name
 
 		inTokenIdx++; // increment index to value
-		if (Member* member = rtti.GetMember(key_string.c_str()))
+		if (Member* member = rtti.GetMember(key_string))
 		{
 			// parse the current value, increment the token index by how many we have parsed
 			inTokenIdx = member->FromJSON(*this, inTokenIdx, &inValue);
@@ -189,21 +215,60 @@ inline uint32_t JSONData::GetTokenToValue(uint32_t inTokenIdx, T& inValue)
 	return inTokenIdx;
 }
 
+template<typename T>
+inline T JSONData::GetNumber(uint32_t inTokenIdx) const
+{
+	const StringView value = GetString(inTokenIdx);
+
+	if (value.empty() || value[0] == 'f' || value[0] == 'n')
+		return T(0);
+
+	if (value[0] == 't')
+		return T(1);
+
+	T result = T(0);
+	const auto [ptr, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+
+	// integers written as 1.0 or 1e3 are parsed as double instead
+	if constexpr (std::is_integral_v<T>)
+	{
+		if (error != std::errc() || ptr != value.data() + value.size())
+		{
+			double number = 0.0;
+			const auto [double_ptr, double_error] = std::from_chars(value.data(), value.data() + value.size(), number);
+
+			// casting a double outside of T's range is undefined, e.g. -1 into an unsigned type, so those become 0
+			const double upper = std::ldexp(1.0, std::numeric_limits<T>::digits);
+			const double lower = std::is_signed_v<T> ? -upper - 1.0 : -1.0;
+
+			if (double_error != std::errc() || !( number > lower && number < upper ))
+			{
+				std::cout << std::format("[JSON] Failed to parse \"{}\" as an integer in range [{}, {}].\n", value, std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+				return T(0);
+			}
+
+			result = T(number);
+		}
+	}
+
+	return result;
+}
+
 template<typename T> requires std::is_enum_v<T>
 uint32_t JSONData::GetTokenToValue(uint32_t inTokenIndex, T& inValue)
 {
-	inValue = (T)GetPrimitive(inTokenIndex++); return inTokenIndex;
+	inValue = (T)GetNumber<std::underlying_type_t<T>>(inTokenIndex++); return inTokenIndex;
 }
 
 template<typename T> requires std::is_arithmetic_v<T>
 inline uint32_t JSONData::GetTokenToValue(uint32_t inTokenIndex, T& inValue)
 {
-	inValue = GetPrimitive(inTokenIndex++); return inTokenIndex;
+	inValue = GetNumber<T>(inTokenIndex++); return inTokenIndex;
 }
 
 inline uint32_t JSONData::GetTokenToValue(uint32_t inTokenIndex, bool& ioBool)
 {
-	ioBool = GetPrimitive(inTokenIndex++); return inTokenIndex;
+	ioBool = GetNumber<int>(inTokenIndex++) != 0; return inTokenIndex;
 }
 
 inline uint32_t JSONData::GetTokenToValue(uint32_t inTokenIndex, std::string& ioString)
@@ -343,13 +408,13 @@ inline void JSONWriter::GetValueToJSON(const T& inMember)
 template<typename T> requires std::is_enum_v<T>
 inline void JSONWriter::GetValueToJSON(const T& inMember)
 {
-	Write(std::to_string((int)inMember));
+	WriteNumber((int)inMember);
 }
 
 template<typename T> requires std::is_arithmetic_v<T>
 inline void JSONWriter::GetValueToJSON(const T& inValue)
 {
-	Write(std::to_string(inValue));
+	WriteNumber(inValue);
 }
 
 inline void JSONWriter::GetValueToJSON(const bool& inBool)
@@ -359,27 +424,27 @@ inline void JSONWriter::GetValueToJSON(const bool& inBool)
 
 inline void JSONWriter::GetValueToJSON(const std::string& inString)
 {
-	Write("\"");
-	Write(inString);
-	Write("\"");
+	Write('"').Write(inString).Write('"');
 }
 
 template<glm::length_t L, typename T>
 inline void JSONWriter::GetValueToJSON(const glm::vec<L, T>& inVec)
 {
-	Write("\"").Write(gToString(inVec)).Write("\"");
+	char buffer[gMaxChars<glm::vec<L, T>>];
+	Write('"').Write(StringView(buffer, gToChars(buffer, buffer + sizeof(buffer), inVec))).Write('"');
 }
 
 inline void JSONWriter::GetValueToJSON(const glm::quat& inQuat)
 {
-	Write("\"" + gToString(inQuat) + "\"");
-
+	char buffer[gMaxChars<glm::quat>];
+	Write('"').Write(StringView(buffer, gToChars(buffer, buffer + sizeof(buffer), inQuat))).Write('"');
 }
 
 template<glm::length_t C, glm::length_t R, typename T>
 inline void JSONWriter::GetValueToJSON(const glm::mat<C, R, T>& inMatrix)
 {
-	Write("\"" + gToString(inMatrix) + "\"");
+	char buffer[gMaxChars<glm::mat<C, R, T>>];
+	Write('"').Write(StringView(buffer, gToChars(buffer, buffer + sizeof(buffer), inMatrix))).Write('"');
 }
 
 
@@ -488,9 +553,10 @@ void JSONWriter::GetValueToJSON(const std::unordered_map<K, V>& inValue)
 
 inline void JSONWriter::GetValueToJSON(const Path& inPath)
 {
-	Write("\"");
-	Write(inPath.generic_string());
-	Write("\"");
+	Write('"').Write(inPath.generic_string()).Write('"');
 }
 
+
+void RunJSONBenchmark();
+
 } // Raekor::JSON
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Maths.h"
 #include "Camera.h"
 #include "Member.h"
+#include "Timer.h"
 
 namespace RK {
 
@@ -363,6 +364,102 @@ bool Frustum::ContainsAABB(const BBox3D& inAABB) const
 	return true;
 }
 
+
+void RunMathsBenchmark()
+{
+	constexpr uint32_t cCount = 100'000;
+
+	Array<Vec3> vectors(cCount);
+	Array<Mat4x4> matrices(cCount);
+
+	for (uint32_t i = 0; i < cCount; i++)
+	{
+		vectors[i] = Vec3(gRandomFloatNO(), gRandomFloatNO(), gRandomFloatNO()) * 1000.0f;
+		matrices[i] = Mat4x4(gRandomRotationMatrix());
+		matrices[i][3] = Vec4(vectors[i], 1.0f);
+	}
+
+	// reference: the old stringstream based conversion
+	const auto StreamToString = [](const auto& inValue, int inCount)
+	{
+		std::stringstream ss;
+		ss << "(";
+		for (int i = 0; i < inCount; i++)
+			ss << glm::value_ptr(inValue)[i] << ( i != inCount - 1 ? " " : "" );
+		ss << ")";
+		return ss.str();
+	};
+
+	const auto StreamFromString = [](const std::string& inString, auto& outValue, int inCount)
+	{
+		std::stringstream ss(inString);
+		char delim;
+		ss >> delim;
+		for (int i = 0; i < inCount; i++)
+			ss >> glm::value_ptr(outValue)[i];
+	};
+
+	Array<String> vector_strings(cCount), matrix_strings(cCount);
+	Vec3 vector_result;
+	Mat4x4 matrix_result;
+
+	Timer timer;
+
+	for (uint32_t i = 0; i < cCount; i++)
+	{
+		vector_strings[i] = StreamToString(vectors[i], 3);
+		matrix_strings[i] = StreamToString(matrices[i], 16);
+	}
+
+	const float stream_write_time = Timer::sToMilliseconds(timer.Restart());
+
+	for (uint32_t i = 0; i < cCount; i++)
+	{
+		StreamFromString(vector_strings[i], vector_result, 3);
+		StreamFromString(matrix_strings[i], matrix_result, 16);
+	}
+
+	const float stream_read_time = Timer::sToMilliseconds(timer.Restart());
+
+	char vector_buffer[gMaxChars<Vec3>];
+	char matrix_buffer[gMaxChars<Mat4x4>];
+	uint64_t char_count = 0; // keeps the writes from being optimized out
+
+	for (uint32_t i = 0; i < cCount; i++)
+	{
+		char_count += gToChars(vector_buffer, vector_buffer + sizeof(vector_buffer), vectors[i]) - vector_buffer;
+		char_count += gToChars(matrix_buffer, matrix_buffer + sizeof(matrix_buffer), matrices[i]) - matrix_buffer;
+	}
+
+	const float chars_write_time = Timer::sToMilliseconds(timer.Restart());
+
+	for (uint32_t i = 0; i < cCount; i++)
+	{
+		vector_strings[i] = gToString(vectors[i]);
+		matrix_strings[i] = gToString(matrices[i]);
+	}
+
+	timer.Restart();
+
+	for (uint32_t i = 0; i < cCount; i++)
+	{
+		gFromChars(vector_strings[i], vector_result);
+		gFromChars(matrix_strings[i], matrix_result);
+	}
+
+	const float chars_read_time = Timer::sToMilliseconds(timer.Restart());
+
+	// shortest round-trip formatting has to give back the exact same bits
+	for (uint32_t i = 0; i < cCount; i++)
+	{
+		assert(gFromString<3, float>(vector_strings[i]) == vectors[i]);
+		assert(gFromString<4, 4, float>(matrix_strings[i]) == matrices[i]);
+	}
+
+	std::cout << std::format("[Maths] Benchmark ({} Vec3 + Mat4x4, {} chars): stringstream write {:.2f} ms, read {:.2f} ms. to_chars write {:.2f} ms, from_chars read {:.2f} ms.\n",
+		cCount, char_count, stream_write_time, stream_read_time, chars_write_time, chars_read_time);
+}
+
 } // raekor
 
 RTTI_DEFINE_TYPE_PRIMITIVE(RK::Vec2);
@@ -6,6 +6,25 @@ namespace RK {
 
 class Viewport;
 
+/* Text form of math types is "(x y z)" for vectors/quats and "((c0) (c1) ..)" for matrices (column major).
+   gToChars/gFromChars work on caller provided memory and don't allocate, components are written with
+   std::to_chars in shortest round-trip form. Buffers of gMaxChars<T> are always large enough. */
+template<glm::length_t L, typename T>
+char* gToChars(char* inFirst, char* inLast, const glm::vec<L, T>& inValue);
+
+template<glm::length_t C, glm::length_t R, typename T>
+char* gToChars(char* inFirst, char* inLast, const glm::mat<C, R, T>& inValue);
+
+char* gToChars(char* inFirst, char* inLast, const glm::quat& inValue);
+
+template<glm::length_t L, typename T>
+bool gFromChars(StringView inString, glm::vec<L, T>& outValue);
+
+template<glm::length_t C, glm::length_t R, typename T>
+bool gFromChars(StringView inString, glm::mat<C, R, T>& outValue);
+
+bool gFromChars(StringView inString, glm::quat& outValue);
+
 template<glm::length_t L, typename T>
 std::string gToString(const glm::vec<L, T>& inValue);
 
@@ -13,10 +32,10 @@ template<glm::length_t C, glm::length_t R, typename T>
 std::string gToString(const glm::mat<C, R, T>& inValue);
 
 template<glm::length_t L, typename T>
-inline glm::vec < L, T> gFromString(const std::string& inValue);
+inline glm::vec < L, T> gFromString(StringView inValue);
 
 template<glm::length_t C, glm::length_t R, typename T>
-inline glm::mat<C, R, T> gFromString(const std::string& inValue);
+inline glm::mat<C, R, T> gFromString(StringView inValue);
 
 
 inline float gRadiansToDegrees(float inValue) { return inValue * ( 180.0f / M_PI ); }
@@ -111,107 +130,157 @@ Mat3x3 gRandomOrientation();
 Mat3x3 gRandomRotationMatrix();
 
 
-template<glm::length_t L, typename T>
-inline std::string gToString(const glm::vec<L, T>& inValue)
+namespace Impl {
+
+template<typename T>
+inline char* ComponentsToChars(char* inFirst, char* inLast, const T* inValues, uint32_t inCount)
 {
-	std::stringstream ss;
-	ss << "(";
-	for (int i = 0; i < L; i++)
+	for (uint32_t i = 0; i < inCount && inFirst != inLast; i++)
 	{
-		ss << inValue[i];
-		if (i != L - 1) ss << " ";
+		if (i != 0) *inFirst++ = ' ';
+		inFirst = std::to_chars(inFirst, inLast, inValues[i]).ptr;
 	}
-	ss << ")";
-	return ss.str();
-}
 
+	return inFirst;
+}
 
-template<glm::length_t C, glm::length_t R, typename T>
-inline std::string gToString(const glm::mat<C, R, T>& inValue)
+template<typename T>
+inline const char* ComponentsFromChars(const char* inFirst, const char* inLast, T* outValues, uint32_t inCount)
 {
-	std::stringstream ss;
-	ss << "((";
-	for (int i = 0; i < C; ++i)
+	for (uint32_t i = 0; i < inCount; i++)
 	{
-		for (int j = 0; j < R; ++j)
-		{
-			ss << inValue[i][j];
-			if (j != R - 1) ss << " ";
-		}
-		if (i != C - 1) ss << ") (";
+		while (inFirst != inLast && ( *inFirst == ' ' || *inFirst == '(' || *inFirst == ')' ))
+			inFirst++;
+
+		const auto [ptr, error] = std::from_chars(inFirst, inLast, outValues[i]);
+		if (error != std::errc())
+			return nullptr;
+
+		inFirst = ptr;
 	}
-	ss << "))";
 
-	return ss.str();
+	return inFirst;
 }
 
+} // namespace Impl
 
-inline std::string gToString(const glm::quat& inValue)
+
+// 24 chars covers the longest shortest-round-trip double, the rest is for separators and parentheses
+template<typename T>
+constexpr size_t gMaxChars = ( sizeof(T) / sizeof(typename T::value_type) ) * 25 + 32;
+
+
+template<glm::length_t L, typename T>
+inline char* gToChars(char* inFirst, char* inLast, const glm::vec<L, T>& inValue)
+{
+	*inFirst++ = '(';
+	inFirst = Impl::ComponentsToChars(inFirst, inLast - 1, &inValue[0], L);
+	*inFirst++ = ')';
+	return inFirst;
+}
+
+
+template<glm::length_t C, glm::length_t R, typename T>
+inline char* gToChars(char* inFirst, char* inLast, const glm::mat<C, R, T>& inValue)
 {
-	std::stringstream ss;
-	ss << "(";
-	for (int i = 0; i < glm::quat::length(); i++)
+	*inFirst++ = '(';
+	for (int i = 0; i < C; i++)
 	{
-		ss << inValue[i];
-		if (i != glm::quat::length() - 1) ss << " ";
+		if (i != 0) *inFirst++ = ' ';
+		*inFirst++ = '(';
+		inFirst = Impl::ComponentsToChars(inFirst, inLast - 2, &inValue[i][0], R);
+		*inFirst++ = ')';
 	}
-	ss << ")";
-	return ss.str();
+	*inFirst++ = ')';
+	return inFirst;
 }
 
 
+inline char* gToChars(char* inFirst, char* inLast, const glm::quat& inValue)
+{
+	*inFirst++ = '(';
+	inFirst = Impl::ComponentsToChars(inFirst, inLast - 1, &inValue[0], glm::quat::length());
+	*inFirst++ = ')';
+	return inFirst;
+}
+
 
 template<glm::length_t L, typename T>
-inline glm::vec < L, T> gFromString(const std::string& inValue)
+inline bool gFromChars(StringView inString, glm::vec<L, T>& outValue)
+{
+	return Impl::ComponentsFromChars(inString.data(), inString.data() + inString.size(), &outValue[0], L) != nullptr;
+}
+
+
+template<glm::length_t C, glm::length_t R, typename T>
+inline bool gFromChars(StringView inString, glm::mat<C, R, T>& outValue)
 {
-	glm::vec < L, T> result;
-	std::stringstream ss(inValue);
+	const char* first = inString.data();
+	const char* last = inString.data() + inString.size();
 
-	char delim;
-	ss >> delim;
+	for (int i = 0; i < C && first; i++)
+		first = Impl::ComponentsFromChars(first, last, &outValue[i][0], R);
 
-	for (int i = 0; i < L; i++)
-		ss >> result[i];
+	return first != nullptr;
+}
 
-	return result;
+
+inline bool gFromChars(StringView inString, glm::quat& outValue)
+{
+	return Impl::ComponentsFromChars(inString.data(), inString.data() + inString.size(), &outValue[0], glm::quat::length()) != nullptr;
 }
 
-template<glm::length_t C, glm::length_t R, typename T>
-inline glm::mat<C, R, T> gFromString(const std::string& inValue)
+
+template<glm::length_t L, typename T>
+inline std::string gToString(const glm::vec<L, T>& inValue)
 {
-	glm::mat<C, R, T> result;
-	std::stringstream ss(inValue);
+	char buffer[gMaxChars<glm::vec<L, T>>];
+	return std::string(buffer, gToChars(buffer, buffer + sizeof(buffer), inValue));
+}
 
-	char delim;
-	ss >> delim >> delim; // eat ((
 
-	for (int i = 0; i < C; ++i)
-	{
-		for (int j = 0; j < R; ++j)
-		{
-			ss >> result[i][j];
-		}
-		ss >> delim >> delim; // eat )( and ))
-	}
+template<glm::length_t C, glm::length_t R, typename T>
+inline std::string gToString(const glm::mat<C, R, T>& inValue)
+{
+	char buffer[gMaxChars<glm::mat<C, R, T>>];
+	return std::string(buffer, gToChars(buffer, buffer + sizeof(buffer), inValue));
+}
 
-	return result;
+
+inline std::string gToString(const glm::quat& inValue)
+{
+	char buffer[gMaxChars<glm::quat>];
+	return std::string(buffer, gToChars(buffer, buffer + sizeof(buffer), inValue));
 }
 
 
-inline glm::quat gFromString(const std::string& inValue)
+template<glm::length_t L, typename T>
+inline glm::vec < L, T> gFromString(StringView inValue)
 {
-	glm::quat result;
-	std::stringstream ss(inValue);
+	glm::vec < L, T> result = {};
+	gFromChars(inValue, result);
+	return result;
+}
 
-	char delim;
-	ss >> delim;
+template<glm::length_t C, glm::length_t R, typename T>
+inline glm::mat<C, R, T> gFromString(StringView inValue)
+{
+	glm::mat<C, R, T> result = {};
+	gFromChars(inValue, result);
+	return result;
+}
 
-	for (int i = 0; i < glm::quat::length(); i++)
-		ss >> result[i];
 
+inline glm::quat gFromString(StringView inValue)
+{
+	glm::quat result = {};
+	gFromChars(inValue, result);
 	return result;
 }
 
+
+void RunMathsBenchmark();
+
 } // namespace Raekor
 
 RTTI_DECLARE_TYPE_PRIMITIVE(RK::Vec2);
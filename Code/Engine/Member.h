@@ -25,18 +25,37 @@ public:
 		return inJSON.GetTokenToValue(inTokenIdx, GetRef<T>(inClass));
 	}
 
-	void ToBinary(File& inFile, const void* inClass) override
+	void ToBinary(ByteBuffer& inBuffer, const void* inClass) override
 	{
-		WriteFileBinary(inFile, GetRef<T>(inClass));
+		WriteFileBinary(inBuffer, GetRef<T>(inClass));
 	}
 
-	void FromBinary(File& inFile, void* inClass) override
+	void FromBinary(ByteBuffer& inBuffer, void* inClass) override
 	{
-		ReadFileBinary(inFile, GetRef<T>(inClass));
+		ReadFileBinary(inBuffer, GetRef<T>(inClass));
 	}
 
 	RTTI* GetRTTI() override { return m_RTTI; }
 
+	bool IsTriviallyCopyable() const override
+	{
+		// a nested RTTI type only copies to the same bytes if its own binary members tile it exactly
+		if constexpr (HasRTTI<T>)
+			return std::is_trivially_copyable_v<T> && RTTI_OF<T>().IsTriviallySerializable();
+		else
+			return std::is_trivially_copyable_v<T>;
+	}
+
+	size_t GetSize() const override { return sizeof(T); }
+	size_t GetClassSize() const override { return sizeof(Class); }
+	BinaryLayout GetBinaryLayout() const override { return gGetBinaryLayout<T>(); }
+
+	size_t GetOffset() const override
+	{
+		alignas(Class) static const uint8_t storage[sizeof(Class)] = {};
+		return (const uint8_t*)&( reinterpret_cast<const Class*>( storage )->*m_Member ) - storage;
+	}
+
 	void* GetPtr(void* inClass) override { return &( static_cast<Class*>( inClass )->*m_Member ); }
 	const void* GetPtr(const void* inClass) override { return &( static_cast<const Class*>( inClass )->*m_Member ); }
 
@@ -136,7 +136,10 @@ bool OBJImporter::LoadFromFile(const String& inFile, Assets* inAssets)
 	}
 
 	if (!mtl_file.empty())
+	{
+		AddFileDependency(m_Directory / mtl_file);
 		LoadMaterials(m_Directory / mtl_file);
+	}
 
 	if (inAssets != nullptr)
 		m_Scene.LoadMaterialTextures(*inAssets);
@@ -145,6 +148,37 @@ bool OBJImporter::LoadFromFile(const String& inFile, Assets* inAssets)
 }
 
 
+Array<String> OBJImporter::sGetFileDependencies(const String& inFile)
+{
+	Array<String> dependencies;
+
+	std::fstream file(inFile, std::ios::in);
+	if (!file.is_open())
+		return dependencies;
+
+	String buffer;
+	while (std::getline(file, buffer))
+	{
+		std::istringstream line(buffer);
+		std::string token;
+		line >> token;
+
+		if (token != "mtllib")
+			continue;
+
+		String mtl_file;
+		line >> mtl_file;
+
+		if (!mtl_file.empty())
+			dependencies.push_back(( Path(inFile).parent_path() / "" / mtl_file ).lexically_normal().string());
+
+		break;
+	}
+
+	return dependencies;
+}
+
+
 void OBJImporter::ConvertMesh(Entity inEntity, const OBJMesh& inMesh)
 {
 	RK_ASSERT(!inMesh.IsEmpty());
@@ -186,7 +220,10 @@ void OBJImporter::ConvertMesh(Entity inEntity, const OBJMesh& inMesh)
 		mesh.CalculateVertices();
 
 	if (m_Renderer)
+	{
+		ProcessMesh(mesh, false);
 		m_Renderer->UploadMeshBuffers(inEntity, mesh);
+	}
 
 	m_Meshes.push_back(inEntity);
 }
@@ -75,6 +75,10 @@ public:
 	OBJImporter(Scene& inScene, IRenderInterface* inRenderer) : Importer(inScene, inRenderer) {}
 	bool LoadFromFile(const String& inFile, Assets* inAssets) override;
 
+	/* The material library LoadFromFile would report through GetFileDependencies, without parsing any geometry. Stops at the first
+		mtllib line, exporters put it at the top so this rarely reads more than a few lines. Doesn't touch CVars, safe to call from jobs. */
+	static Array<String> sGetFileDependencies(const String& inFile);
+
 private:
 	bool LoadMaterials(const Path& inFilePath);
 	void ConvertMesh(Entity inEntity, const OBJMesh& inMesh);
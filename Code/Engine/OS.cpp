@@ -1,6 +1,13 @@
 #include "pch.h"
 #include "OS.h"
 
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace RK {
 
 #ifdef WIN32
@@ -231,6 +238,59 @@ String OS::sSelectFolderDialog()
 	return std::string();
 }
 
+
+bool OS::MappedFile::Open(const Path& inPath)
+{
+	Close();
+
+	HANDLE file = CreateFileW(inPath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size = {};
+	// empty files can't be mapped
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	m_Data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	m_Size = size_t(size.QuadPart);
+	m_File = file;
+	m_Mapping = mapping;
+
+	if (m_Data == nullptr)
+		Close();
+
+	return m_Data != nullptr;
+}
+
+
+void OS::MappedFile::Close()
+{
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+
+	if (m_Mapping)
+		CloseHandle(m_Mapping);
+
+	if (m_File)
+		CloseHandle(m_File);
+
+	m_Data = nullptr;
+	m_Size = 0;
+	m_File = nullptr;
+	m_Mapping = nullptr;
+}
+
 #else 
 
 std::string PlatformContext::openFileDialog(const std::vector<Ffilter>& filters)
@@ -290,6 +350,46 @@ std::string PlatformContext::openFileDialog(const std::vector<Ffilter>& filters)
 	return file;
 }
 
+
+bool OS::MappedFile::Open(const Path& inPath)
+{
+	Close();
+
+	const int file = open(inPath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file < 0)
+		return false;
+
+	struct stat info = {};
+	// empty files can't be mapped
+	if (fstat(file, &info) != 0 || info.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+	// the mapping keeps its own reference to the file
+	close(file);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	m_Data = (const uint8_t*)data;
+	m_Size = size_t(info.st_size);
+	return true;
+}
+
+
+void OS::MappedFile::Close()
+{
+	if (m_Data)
+		munmap((void*)m_Data, m_Size);
+
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
 #endif
 
 } // Namespace Raekor
\ No newline at end of file
@@ -33,4 +33,30 @@ Path sGetTempPath();
 Path sGetExecutablePath();
 Path sGetExecutableDirectoryPath();
 
+
+/* Read only view of an entire file, pages are only read from disk when first touched. The file can't be written to while mapped. */
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const Path& inPath) { Open(inPath); }
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { Close(); }
+
+	bool Open(const Path& inPath);
+	void Close();
+
+	bool IsOpen() const { return m_Data != nullptr; }
+
+	const uint8_t* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+
+private:
+	const uint8_t* m_Data = nullptr;
+	size_t m_Size = 0;
+	void* m_File = nullptr; // only used on Windows, mmap doesn't need the descriptor after mapping
+	void* m_Mapping = nullptr;
+};
+
 } // namespace Raekor::OS
@@ -168,6 +168,7 @@ using ComPtr = Microsoft::WRL::ComPtr<T>;
 #include <optional>
 #include <iostream>
 #include <semaphore>
+#include <shared_mutex>
 #include <execution>
 #include <algorithm>
 #include <filesystem>
@@ -188,6 +189,7 @@ using StringView = std::string_view;
 using StringBuilder = std::stringstream;
 
 using Mutex = std::mutex;
+using SharedMutex = std::shared_mutex;
 
 template<typename T>
 using Slice = std::span<T>;
@@ -136,16 +136,21 @@ void Physics::OnUpdate(Scene& inScene)
         }
     }
     */
+
+    // only wait on our own jobs, WaitForJobs would also wait on scene streaming and saving which run across many frames
+    Array<Job::Ptr> jobs;
+
     for (const auto& [entity, transform, mesh, rigid_body] : inScene.Each<Transform, Mesh, RigidBody>())
     {
         if (rigid_body.bodyID.IsInvalid() && rigid_body.shape == RigidBody::MESH)
         {
-            g_ThreadPool.QueueJob([&]()
+            // capture the components, not the bindings of a tuple that's gone by the time the job runs
+            jobs.push_back(g_ThreadPool.QueueJob([this, &transform = transform, &mesh = mesh, &rigid_body = rigid_body]()
             {
                 rigid_body.CreateMeshCollider(*this, mesh, transform);
                 rigid_body.CreateBody(*this, transform);
                 rigid_body.ActivateBody(*this, transform);
-            });
+            }));
         }
     }
 
@@ -203,26 +208,30 @@ void Physics::OnUpdate(Scene& inScene)
 		m_Physics->DrawBodies(draw_settings, JPH::DebugRenderer::sInstance);
 	}
 
-    g_ThreadPool.WaitForJobs();
+    for (const Job::Ptr& job : jobs)
+        g_ThreadPool.WaitForJob(job);
 }
 
 
 void Physics::GenerateRigidBodiesEntireScene(Scene& inScene)
 {
+    Array<Job::Ptr> jobs;
+
 	for (const auto& [entity, transform, mesh, rigid_body] : inScene.Each<Transform, Mesh, RigidBody>())
 	{
         if (rigid_body.bodyID.IsInvalid())
         {
-		    g_ThreadPool.QueueJob([&]()
+		    jobs.push_back(g_ThreadPool.QueueJob([this, &transform = transform, &mesh = mesh, &rigid_body = rigid_body]()
 		    {
                 rigid_body.CreateMeshCollider(*this, mesh, transform);
                 rigid_body.CreateBody(*this, transform);
                 rigid_body.ActivateBody(*this, transform);
-		    });
+		    }));
         }
 	}
 
-    g_ThreadPool.WaitForJobs();
+    for (const Job::Ptr& job : jobs)
+        g_ThreadPool.WaitForJob(job);
 }
 
 
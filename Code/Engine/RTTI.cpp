@@ -14,15 +14,42 @@ RTTI::RTTI(const char* inName)
 }
 
 
-RTTI::RTTI(const char* inName, CreateFn inCreateFn, Constructor inConstructor)
+RTTI::RTTI(const char* inName, CreateFn inCreateFn, Constructor inConstructor, ValidateFn inValidateFn)
 	: mHash(gHash32Bit(inName)), m_Name(inName), m_Constructor(inConstructor)
 {
 	inCreateFn(*this);
+
+	// every binary member has to start exactly where the previous one ended, and together they have to span the whole type
+	size_t offset = 0;
+	m_TriviallySerializable = !m_Members.empty();
+
+	for (const auto& member : m_Members)
+	{
+		if (( member->GetSerializeType() & SERIALIZE_BINARY ) == 0 || !member->IsTriviallyCopyable() || member->GetOffset() != offset)
+		{
+			m_TriviallySerializable = false;
+			break;
+		}
+
+		offset += member->GetSize();
+	}
+
+	if (m_TriviallySerializable)
+		m_TriviallySerializable = offset == m_Members[0]->GetClassSize();
+
+	if (inValidateFn)
+		inValidateFn(*this);
 }
 
 
 void RTTI::AddMember(Member* inMember)
 {
+	const uint32_t index = uint32_t(m_Members.size());
+
+	// the first member to claim a name wins, same as the linear search used to
+	m_MemberIndices.try_emplace(inMember->GetNameHash(), index);
+	m_MemberIndices.try_emplace(inMember->GetCustomNameHash(), index);
+
 	m_Members.emplace_back(std::unique_ptr<Member>(inMember));
 }
 
@@ -35,23 +62,33 @@ Member* RTTI::GetMember(uint32_t inIndex) const
 
 Member* RTTI::GetMember(const char* inName) const
 {
-	const uint32_t name_hash = gHash32Bit(inName);
-	for (const auto& member : m_Members)
-		if (name_hash == member->GetNameHash() || name_hash == member->GetCustomNameHash())
-			return member.get();
+	return GetMemberByHash(gHash32Bit(inName));
+}
 
-	return nullptr;
+
+Member* RTTI::GetMember(StringView inName) const
+{
+	return GetMemberByHash(gHash32Bit(inName));
 }
 
 
 int32_t RTTI::GetMemberIndex(const char* inName) const
 {
-	const uint32_t name_hash = gHash32Bit(inName);
-	for (const auto& [index, member] : gEnumerate(m_Members))
-		if (name_hash == member->GetNameHash() || name_hash == member->GetCustomNameHash())
-			return index;
+	return GetMemberIndexByHash(gHash32Bit(inName));
+}
 
-	return -1;
+
+Member* RTTI::GetMemberByHash(uint32_t inNameHash) const
+{
+	const auto iter = m_MemberIndices.find(inNameHash);
+	return iter != m_MemberIndices.end() ? m_Members[iter->second].get() : nullptr;
+}
+
+
+int32_t RTTI::GetMemberIndexByHash(uint32_t inNameHash) const
+{
+	const auto iter = m_MemberIndices.find(inNameHash);
+	return iter != m_MemberIndices.end() ? int32_t(iter->second) : -1;
 }
 
 
@@ -93,12 +130,38 @@ bool RTTI::IsDerivedFrom(RTTI* inRTTI) const
 
 
 
+uint32_t gGetSchemaHash(const RTTI& inRTTI)
+{
+	// types that contain themselves (bone hierarchies) only hash their name the second time around
+	thread_local Array<const RTTI*> visiting;
+
+	if (std::find(visiting.begin(), visiting.end(), &inRTTI) != visiting.end())
+		return inRTTI.GetHash();
+
+	visiting.push_back(&inRTTI);
+
+	Array<uint32_t> schema;
+	for (const auto& member : inRTTI)
+	{
+		if (( member->GetSerializeType() & SERIALIZE_BINARY ) == 0)
+			continue;
+
+		const BinaryLayout layout = member->GetBinaryLayout();
+		schema.insert(schema.end(), { member->GetNameHash(), uint32_t(layout.kind), layout.size, layout.schema });
+	}
+
+	visiting.pop_back();
+
+	// 0 is reserved for layouts that don't hold an RTTI type
+	const uint32_t hash = uint32_t(gHashFNV1a((const char*)schema.data(), schema.size() * sizeof(uint32_t)));
+	return hash ? hash : 1;
+}
+
+
 RTTI* RTTIFactory::GetRTTI(uint32_t inHash)
 {
-	if (m_RegisteredTypes.contains(inHash))
-		return m_RegisteredTypes.at(inHash);
-	else
-		return nullptr;
+	const auto iter = m_RegisteredTypes.find(inHash);
+	return iter != m_RegisteredTypes.end() ? iter->second : nullptr;
 }
 
 
@@ -107,14 +170,20 @@ RTTI* RTTIFactory::GetRTTI(const char* inType)
 	return GetRTTI(gHash32Bit(inType));
 }
 
-void* RTTIFactory::Construct(const char* inType)
+void* RTTIFactory::Construct(uint32_t inHash)
 {
-	if (RTTI* rtti = GetRTTI(inType))
-		return rtti->m_Constructor();
+	if (RTTI* rtti = GetRTTI(inHash))
+		return rtti->Construct();
 	else
 		return nullptr;
 }
 
+
+void* RTTIFactory::Construct(const char* inType)
+{
+	return Construct(gHash32Bit(inType));
+}
+
 } // namespace Raekor
 
 RTTI_DEFINE_TYPE_PRIMITIVE(int);
@@ -22,19 +22,28 @@ class RTTI
 
 	using CreateFn = void( * )( RTTI& rtti );
 	using Constructor = void* ( * )( );
+	using ValidateFn = void( * )( const RTTI& rtti );
 
 public:
 	RTTI(const char* inName);
-	RTTI(const char* inName, CreateFn inCreateFn, Constructor inConstructor);
+	RTTI(const char* inName, CreateFn inCreateFn, Constructor inConstructor, ValidateFn inValidateFn = nullptr);
 	RTTI(RTTI&) = delete;
 	RTTI(RTTI&&) = delete;
 
 	void      AddMember(Member* inName);
 	Member*   GetMember(uint32_t inIndex) const;
-	Member*   GetMember(const char* inName) const; // O(n) Expensive!
-	int32_t   GetMemberIndex(const char* inName) const; // O(n) expensive!
+	Member*   GetMember(const char* inName) const;
+	Member*   GetMember(StringView inName) const;
+	int32_t   GetMemberIndex(const char* inName) const;
+
+	/* O(1) lookups by gHash32Bit of either the member name or its custom name, pass a constexpr hash to skip hashing entirely. */
+	Member*   GetMemberByHash(uint32_t inNameHash) const;
+	int32_t   GetMemberIndexByHash(uint32_t inNameHash) const;
 	uint32_t  GetMemberCount() const { return uint32_t(m_Members.size()); }
 
+	/* True if the binary members are trivially copyable and tightly cover the entire type in declaration order, so a single memcpy gives the same bytes. */
+	bool      IsTriviallySerializable() const { return m_TriviallySerializable; }
+
 	void      AddBaseClass(RTTI& inRTTI);
 	RTTI*     GetBaseClass(uint32_t inIndex) const;
 	uint32_t  GetBaseClassCount() const { return uint32_t(m_BaseClasses.size()); }
@@ -53,6 +62,8 @@ public:
 	constexpr inline uint32_t GetHash() const { return mHash; }
 	inline const char* GetTypeName() const { return m_Name.c_str(); }
 
+	void*     Construct() const { return m_Constructor ? m_Constructor() : nullptr; }
+
 	inline const auto end() const { return m_Members.end(); }
 	inline const auto begin() const { return m_Members.begin(); }
 
@@ -60,9 +71,11 @@ public:
 
 private:
 	String m_Name;
-	Constructor m_Constructor;
+	bool m_TriviallySerializable = false;
+	Constructor m_Constructor = nullptr;
 	Array<RTTI*> m_BaseClasses;
 	Array<std::unique_ptr<Member>> m_Members;
+	HashMap<uint32_t, uint32_t> m_MemberIndices; // name and custom name hashes to member index
 };
 
 
@@ -84,6 +97,15 @@ public:
 
 	virtual RTTI* GetRTTI() { return nullptr; }
 
+	// layout info used to detect trivially serializable types
+	virtual bool   IsTriviallyCopyable() const { return false; }
+	virtual size_t GetSize() const { return 0; }
+	virtual size_t GetOffset() const { return 0; }
+	virtual size_t GetClassSize() const { return 0; }
+
+	// how the member is stored in binary archives, recorded in type tables so removed members can be skipped
+	virtual BinaryLayout GetBinaryLayout() const { return {}; }
+
 	template<typename T>
 	T* Get(void* inClass) { return static_cast<T*>( GetPtr(inClass) ); }
 	template<typename T>
@@ -94,8 +116,8 @@ public:
 	template<typename T>
 	const T& GetRef(const void* inClass) { return *static_cast<const T*>( GetPtr(inClass) ); }
 
-	virtual void ToBinary(File& inFile, const void* inClass) {}
-	virtual void FromBinary(File& inFile, void* inClass) {}
+	virtual void ToBinary(ByteBuffer& inBuffer, const void* inClass) {}
+	virtual void FromBinary(ByteBuffer& inBuffer, void* inClass) {}
 
 	virtual void     ToJSON(JSON::JSONWriter& inJSON, const void* inClass) {}
 	virtual uint32_t FromJSON(JSON::JSONData& inJSON, uint32_t inTokenIdx, void* inClass) { return 0; }
@@ -109,6 +131,49 @@ protected:
 };
 
 
+/* The member list has to be the binary members of the RTTI in the same order, or the two paths would produce different bytes. */
+template<typename T> requires HasSerializer<T>
+inline bool gSerializerMatchesRTTI(const RTTI& inRTTI)
+{
+	alignas(T) static const uint8_t storage[sizeof(T)] = {};
+	const T* object = reinterpret_cast<const T*>( storage );
+
+	Array<size_t> offsets;
+	std::apply([&](auto... inMembers) { ( offsets.push_back((const uint8_t*)&( object->*inMembers ) - storage), ... ); }, T::sGetSerializedMembers());
+
+	size_t index = 0;
+	for (const auto& member : inRTTI)
+	{
+		if (( member->GetSerializeType() & SERIALIZE_BINARY ) == 0)
+			continue;
+
+		if (index >= offsets.size() || offsets[index] != member->GetOffset())
+			return false;
+
+		index++;
+	}
+
+	return index == offsets.size();
+}
+
+template<typename T> requires HasSerializer<T>
+inline bool gSerializerMatchesRTTI() { return gSerializerMatchesRTTI<T>(RTTI_OF<T>()); }
+
+/* Called by RTTI_DEFINE_TYPE once the members are known, in every build config since a mismatched serializer silently corrupts files. */
+template<typename T>
+inline void gValidateSerializer(const RTTI& inRTTI)
+{
+	if constexpr (HasSerializer<T>)
+	{
+		if (!gSerializerMatchesRTTI<T>(inRTTI))
+		{
+			std::cerr << std::format("[RTTI] RTTI_DECLARE_SERIALIZER of {} does not list its binary members in RTTI order.\n", inRTTI.GetTypeName());
+			std::abort();
+		}
+	}
+}
+
+
 class RTTIFactory
 {
 public:
@@ -116,10 +181,12 @@ public:
 	void Register() { Register(RTTI_OF<T>()); }
 	void Register(RTTI& inRTTI);
 
+	/* RTTI objects are never moved or destroyed, callers on hot paths should look them up once and keep the pointer. */
 	RTTI* GetRTTI(uint32_t inHash);
 	RTTI* GetRTTI(const char* inType);
     bool HasRTTI(const char* inType) { return GetRTTI(inType) != nullptr; }
 
+	void* Construct(uint32_t inHash);
 	void* Construct(const char* inType);
 
 	inline auto begin() const { return std::views::values(m_RegisteredTypes).begin(); }
@@ -186,11 +253,18 @@ public:
 #define RTTI_DECLARE_TYPE(type) __RTTI_DECLARE_TYPE(type,)
 #define RTTI_DECLARE_VIRTUAL_TYPE(type) __RTTI_DECLARE_TYPE(type, virtual)
 
+/* Opt-in compile time serializer, place at the end of the type and list its binary members
+   in the same order as the RTTI_DEFINE_MEMBER calls, e.g. RTTI_DECLARE_SERIALIZER(&Mesh::bbox, &Mesh::positions).
+   Both lists are written by hand, so member edits have to touch both. */
+#define RTTI_DECLARE_SERIALIZER(...)                                                                                    \
+public:                                                                                                                 \
+    static constexpr auto sGetSerializedMembers() { return std::make_tuple(__VA_ARGS__); }
+
 /// TYPE DEFINITION MACROS ///
 
 #define __RTTI_DEFINE_TYPE(type, factory_type, inline_qualifier)                                                        \
     inline_qualifier RTTI& sGetRTTI(const type* inType) {                                                               \
-        static RTTI rtti = RTTI(#type, &type::sImplRTTI, []() -> void* { return factory_type; });                       \
+        static RTTI rtti = RTTI(#type, &type::sImplRTTI, []() -> void* { return factory_type; }, &gValidateSerializer<type>); \
         return rtti;                                                                                                    \
     }                                                                                                                   \
                                                                                                                         \
@@ -208,6 +282,8 @@ public:
 #define RTTI_DEFINE_TYPE_INHERITANCE(derived_class_type, base_class_type) \
     inRTTI.AddBaseClass(RTTI_OF<base_class_type>())
 
+/* Types with an RTTI_DECLARE_SERIALIZER list their binary members a second time in the header, adding, removing or reordering
+   a member here means editing that list too. gValidateSerializer aborts at startup when the two disagree. */
 #define RTTI_DEFINE_MEMBER(class_type, serial_type, custom_type_string, member_type) \
     inRTTI.AddMember(new ClassMember<class_type, decltype(class_type::member_type)>(#member_type, custom_type_string, &class_type::member_type, nullptr, serial_type))
 
@@ -17,7 +17,7 @@ uint32_t RayTracedScene::GetInstanceIndex(Entity inEntity) const
 }
 
 
-void RayTracedScene::UpdateBLAS(Application* inApp, Device& inDevice, Mesh& inMesh, Skeleton& inSkeleton, CommandList& inCmdList)
+void RayTracedScene::UpdateBLAS(Application* inApp, Device& inDevice, const Mesh& inMesh, const Skeleton& inSkeleton, CommandList& inCmdList)
 {
     D3D12_RAYTRACING_GEOMETRY_DESC geom = {};
     geom.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
@@ -169,20 +169,23 @@ void RayTracedScene::UploadSkeleton(Application* inApp, Device& inDevice, Skelet
 
 void RayTracedScene::UploadTLAS(Application* inApp, Device& inDevice, CommandList& inCmdList)
 {
-    if (!m_Scene.Count<Mesh>())
+    // per-frame walk, go through const access so it never marks the storages dirty
+    const Scene& scene = m_Scene;
+
+    if (!scene.Count<Mesh>())
         return;
 
     PIXScopedEvent(static_cast<ID3D12GraphicsCommandList*>( inCmdList ), PIX_COLOR(0, 255, 0), "UPLOAD TLAS");
 
     Array<D3D12_RAYTRACING_INSTANCE_DESC> rt_instances;
-    rt_instances.reserve(m_Scene.Count<Mesh>());
+    rt_instances.reserve(scene.Count<Mesh>());
 
-    for (const auto& [entity, mesh] : m_Scene.Each<Mesh>())
+    for (const auto& [entity, mesh] : scene.Each<Mesh>())
     {
         if (!mesh.IsLoaded())
             continue;
 
-        const Transform* transform = m_Scene.GetPtr<Transform>(entity);
+        const Transform* transform = scene.GetPtr<Transform>(entity);
         if (!transform)
             continue;
 
@@ -190,7 +193,7 @@ void RayTracedScene::UploadTLAS(Application* inApp, Device& inDevice, CommandLis
             continue;
 
         // vertex animation and custom pixel shaders are unsupported for now
-        if (const Material* material = m_Scene.GetPtr<Material>(mesh.material))
+        if (const Material* material = scene.GetPtr<Material>(mesh.material))
         {
             if (material->vertexShader || material->pixelShader)
                 continue;
@@ -198,7 +201,7 @@ void RayTracedScene::UploadTLAS(Application* inApp, Device& inDevice, CommandLis
 
         Buffer& blas_buffer = inDevice.GetBuffer(BufferID(mesh.BottomLevelAS));
 
-        int instance_index = m_Scene.GetPackedIndex<Mesh>(entity);
+        int instance_index = scene.GetPackedIndex<Mesh>(entity);
         assert(instance_index != -1);
 
         D3D12_RAYTRACING_INSTANCE_DESC instance =
@@ -321,21 +324,24 @@ void RayTracedScene::UploadLights(Application* inApp, Device& inDevice, CommandL
 
 void RayTracedScene::UploadInstances(Application* inApp, Device& inDevice, CommandList& inCmdList)
 {
-    if (!m_Scene.Count<Mesh>())
+    // per-frame walk, go through const access so it never marks the storages dirty
+    const Scene& scene = m_Scene;
+
+    if (!scene.Count<Mesh>())
         return;
 
     PIXScopedEvent(static_cast<ID3D12GraphicsCommandList*>( inCmdList ), PIX_COLOR(0, 255, 0), "UPLOAD INSTANCES");
 
-    const uint32_t nr_of_meshes = m_Scene.Count<Mesh>();
+    const uint32_t nr_of_meshes = scene.Count<Mesh>();
     Array<RTGeometry> rt_geometries;
     rt_geometries.reserve(nr_of_meshes);
 
-    for (const auto& [entity, mesh] : m_Scene.Each<Mesh>())
+    for (const auto& [entity, mesh] : scene.Each<Mesh>())
     {
         if (!mesh.IsLoaded())
             continue;
 
-        const Transform* transform = m_Scene.GetPtr<Transform>(entity);
+        const Transform* transform = scene.GetPtr<Transform>(entity);
 
         if (!transform)
             continue;
@@ -343,11 +349,11 @@ void RayTracedScene::UploadInstances(Application* inApp, Device& inDevice, Comma
         if (!BufferID(mesh.BottomLevelAS).IsValid())
             continue;
 
-        int material_index = m_Scene.GetPackedIndex<Material>(mesh.material);
+        int material_index = scene.GetPackedIndex<Material>(mesh.material);
         material_index = material_index == -1 ? 0 : material_index;
 
         uint32_t vertex_buffer = mesh.vertexBuffer;
-        if (Skeleton* skeleton = m_Scene.GetPtr<Skeleton>(entity))
+        if (const Skeleton* skeleton = scene.GetPtr<Skeleton>(entity))
             vertex_buffer = skeleton->skinnedVertexBuffer;
 
         rt_geometries.emplace_back(RTGeometry
@@ -452,10 +452,6 @@ const GBufferData& AddGBufferPass(RenderGraph& inRenderGraph, Device& inDevice,
             if (!inScene->Has<Transform>(entity))
                 continue;
 
-            // not marked for vis buffer?
-            if (!mesh.meshlets.empty())
-                continue;
-
             const Material* material = inScene->GetPtr<Material>(mesh.material);
 
             if (material == nullptr)
@@ -187,10 +187,10 @@ void Renderer::OnRender(Application* inApp, Device& inDevice, Viewport& inViewpo
 {
     PROFILE_FUNCTION_CPU();
 
-    // Check if any of the shader sources were updated and recompile them if necessary.
-    // the OS file stamp checks are expensive so we only turn this on in debug builds.
-    static bool force_hotload = OS::sCheckCommandLineOption("-force_enable_hotload");
-    bool need_recompile = IF_DEBUG_ELSE(g_SystemShaders.OnHotLoad(inDevice), force_hotload ? g_SystemShaders.OnHotLoad(inDevice) : false);
+    // Recompile shaders whose sources were updated, the watcher tells us when to look so this is cheap enough for every build.
+    bool need_recompile = false;
+    if (!m_ShaderWatcher.PollChanges().empty())
+        need_recompile = g_SystemShaders.OnHotLoad(inDevice);
     if (need_recompile)
         std::cout << std::format("Hotloaded system shaders.\n");
 
@@ -372,7 +372,8 @@ void Renderer::OnRender(Application* inApp, Device& inDevice, Viewport& inViewpo
             {
                 PIXScopedEvent(static_cast<ID3D12GraphicsCommandList*>( copy_cmd_list ), PIX_COLOR(0, 255, 0), "BUILD BLASes");
 
-                for (const auto& [entity, mesh, skeleton] : inScene->Each<Mesh, Skeleton>())
+                const Scene& scene = inScene;
+                for (const auto& [entity, mesh, skeleton] : scene.Each<Mesh, Skeleton>())
                     inScene.UpdateBLAS(inApp, inDevice, mesh, skeleton, copy_cmd_list);
             }
 
@@ -900,16 +901,28 @@ void RenderInterface::ReleaseMaterialShaders(Entity inEntity, Material& inMateri
 }
 
 
-uint32_t RenderInterface::UploadTextureFromAsset(TextureAsset::Ptr inAsset, bool inIsSRGB, uint8_t inSwizzle)
+uint32_t RenderInterface::UploadTextureFromAsset(TextureAsset::Ptr inAsset, bool inIsSRGB, uint8_t inSwizzle, uint32_t inMostDetailedMip)
 {
-    dds::Header header = dds::read_header(inAsset->GetData(), inAsset->GetDataSize());
+    // only Assets loads the asset, once it's ready the header never changes
+    if (!inAsset || !inAsset->IsReady())
+        return TextureID().GetValue();
+
+    const dds::Header& header = inAsset->GetHeader();
     assert(header.is_valid());
 
+    // always keep at least the smallest mip
+    uint32_t first_mip = std::min(inMostDetailedMip, header.mip_levels() - 1);
+
+    // the top mip of a block compressed texture has to be a multiple of the block size, smaller mips are padded by the converter
+    const uint32_t block_size = header.block_size();
+    while (first_mip > 0 && ( ( header.width() >> first_mip ) % block_size || ( header.height() >> first_mip ) % block_size ))
+        first_mip--;
+
     Texture::Desc desc = {};
     desc.swizzle = inSwizzle;
-    desc.width = header.width();
-    desc.height = header.height();
-    desc.mipLevels = header.mip_levels();
+    desc.width = std::max(header.width() >> first_mip, 1u);
+    desc.height = std::max(header.height() >> first_mip, 1u);
+    desc.mipLevels = header.mip_levels() - first_mip;
     desc.depthOrArrayLayers = header.array_size();
     desc.usage = Texture::SHADER_READ_ONLY;
     desc.format = (DXGI_FORMAT)header.format();
@@ -923,23 +936,32 @@ uint32_t RenderInterface::UploadTextureFromAsset(TextureAsset::Ptr inAsset, bool
     if (header.is_cubemap())
         desc.dimension = Texture::TEX_DIM_CUBE;
 
-    // HACK: texture conversion is hardcoded to BC3_UNORM, so add SRGB here..
-    if (inIsSRGB && !gIsDXGIFormatSRGB(desc.format))
+    // conversion always writes UNORM formats, add SRGB here if the format has a variant for it
+    if (inIsSRGB && !gIsDXGIFormatSRGB(desc.format) && gDXGIFormatToSRGB(desc.format) != DXGI_FORMAT_UNKNOWN)
         desc.format = gDXGIFormatToSRGB(desc.format);
 
+    // single channel masks only store red, the material swizzle might point at a channel of a packed texture
+    if (desc.format == DXGI_FORMAT_BC4_UNORM)
+        desc.swizzle = TEXTURE_SWIZZLE_RRRR;
+
     String debug_name = inAsset->GetPath().string();
     desc.debugName = debug_name.c_str();
 
     const TextureID texture = m_Device.CreateTexture(desc);
 
+    // keeps Assets::ReleaseData from pulling the data out from under us, maps it again if it was released after an earlier upload
+    const auto data_lock = inAsset->LockData();
+
     for (uint32_t layer = 0; layer < desc.depthOrArrayLayers; layer++)
     {
         for (uint32_t mip = 0; mip < desc.mipLevels; mip++)
         {
-            size_t data_offset = header.mip_offset(mip, layer);
-            const uint8_t* data_ptr = inAsset->GetData() + data_offset;
+            // mapped file, only the pages of the mips we upload are read from disk
+            const ByteSlice mip_data = inAsset->GetMipData(first_mip + mip, layer);
+            if (mip_data.empty())
+                continue;
 
-            m_Device.UploadTextureData(m_Device.GetTexture(texture), mip, layer, header.row_pitch(mip), data_ptr);
+            m_Device.UploadTextureData(m_Device.GetTexture(texture), mip, layer, header.row_pitch(first_mip + mip), mip_data.data());
         }
     }
 
@@ -1091,6 +1113,8 @@ void RenderInterface::DrawDebugSettings(Application* inApp, Scene& inScene, cons
                     light.color.a /= 1000.0f;
                 }
             }
+
+            inScene.MarkDirty<Light>();
         }
 
         if (ImGui::Button("Re-calculate Normals"))
@@ -1101,18 +1125,24 @@ void RenderInterface::DrawDebugSettings(Application* inApp, Scene& inScene, cons
                 mesh.CalculateTangents();
                 mesh.CalculateVertices();
             }
+
+            inScene.MarkDirty<Mesh>();
         }
 
         if (ImGui::Button("Material albedo 1"))
         {
             for (const auto& [entity, material] : inScene.Each<Material>())
                 material.albedo = Vec4(1.0f);
+
+            inScene.MarkDirty<Material>();
         }
 
         if (ImGui::Button("Material albedo 2"))
         {
             for (const auto& [entity, material] : inScene.Each<Material>())
                 material.albedo *= Vec4(2.0f);
+
+            inScene.MarkDirty<Material>();
         }
 
         if (ImGui::Button("Flip mesh uvs Y"))
@@ -1126,6 +1156,8 @@ void RenderInterface::DrawDebugSettings(Application* inApp, Scene& inScene, cons
 
                 UploadMeshBuffers(entity, mesh);
             }
+
+            inScene.MarkDirty<Mesh>();
         }
 
 
@@ -1133,57 +1165,6 @@ void RenderInterface::DrawDebugSettings(Application* inApp, Scene& inScene, cons
         {
         }
 
-        if (ImGui::Button("Generate Meshlets"))
-        {
-            Timer timer;
-
-            inApp->LogMessage("Generating Meshlets..");
-
-            for (const auto& [entity, mesh] : inScene.Each<Mesh>())
-            {
-                const size_t max_vertices = 64;
-                const size_t max_triangles = 124;
-                const float cone_weight = 0.0f;
-
-                size_t max_meshlets = meshopt_buildMeshletsBound(mesh.indices.size(), max_vertices, max_triangles);
-                Array<meshopt_Meshlet> meshlets(max_meshlets);
-                Array<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
-                Array<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
-
-                size_t meshlet_count = meshopt_buildMeshlets(meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(), mesh.indices.data(),
-                    mesh.indices.size(), &mesh.positions[0].x, mesh.positions.size(), sizeof(mesh.positions[0]), max_vertices, max_triangles, cone_weight);
-
-                meshlets.resize(meshlet_count);
-                meshlet_vertices.resize(meshlet_count * max_vertices);
-                meshlet_triangles.resize(meshlet_count * max_triangles * 3);
-
-                mesh.meshlets.reserve(meshlet_count);
-                mesh.meshletIndices.resize(meshlet_count * max_vertices);
-                mesh.meshletTriangles.resize(meshlet_count * max_triangles);
-
-                for (const meshopt_Meshlet& opt_meshlet : meshlets)
-                {
-                    Meshlet& meshlet = mesh.meshlets.emplace_back();
-                    meshlet.mTriangleCount = opt_meshlet.triangle_count;
-                    meshlet.mTriangleOffset = opt_meshlet.triangle_offset;
-                    meshlet.mVertexCount = opt_meshlet.vertex_count;
-                    meshlet.mVertexOffset = opt_meshlet.vertex_offset;
-                }
-
-                assert(mesh.meshletIndices.size() == meshlet_vertices.size());
-                std::memcpy(mesh.meshletIndices.data(), meshlet_vertices.data(), mesh.meshletIndices.size());
-
-                for (uint32_t idx = 0; idx < mesh.meshletTriangles.size(); idx += 3)
-                {
-                    mesh.meshletTriangles[idx].mX = meshlet_triangles[idx];
-                    mesh.meshletTriangles[idx].mY = meshlet_triangles[idx + 1];
-                    mesh.meshletTriangles[idx].mZ = meshlet_triangles[idx + 2];
-                }
-            }
-
-            inApp->LogMessage(std::format("Generating Meshlets took {:.3f} seconds.", timer.GetElapsedTime()));
-        }
-
         if (ImGui::Button("Save As GraphViz.."))
         {
             const String file_path = OS::sSaveFileDialog("DOT File (*.dot)\0", "dot");
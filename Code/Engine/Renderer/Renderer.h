@@ -7,6 +7,7 @@
 #include "RenderPasses.h"
 
 #include "Threading.h"
+#include "FileWatcher.h"
 #include "Application.h"
 
 namespace RK {
@@ -123,6 +124,7 @@ private:
     GlobalConstants             m_GlobalConstants = {};
     Upscaler                    m_Upscaler;
     RenderGraph                 m_RenderGraph;
+    FileWatcher                 m_ShaderWatcher { "Assets/Shaders" };
 };
 
 
@@ -160,7 +162,7 @@ public:
     void CompileMaterialShaders(Entity inEntity, Material& inMaterial) override;
     void ReleaseMaterialShaders(Entity inEntity, Material& inMaterial) override;
 
-    uint32_t UploadTextureFromAsset(TextureAsset::Ptr inAsset, bool inIsSRGB = false, uint8_t inSwizzle = TEXTURE_SWIZZLE_RGBA) override;
+    uint32_t UploadTextureFromAsset(TextureAsset::Ptr inAsset, bool inIsSRGB = false, uint8_t inSwizzle = TEXTURE_SWIZZLE_RGBA, uint32_t inMostDetailedMip = 0) override;
 
     uint32_t GetSelectedEntity(const Scene& inScene, uint32_t inScreenPosX, uint32_t inScreenPosY) override;
 
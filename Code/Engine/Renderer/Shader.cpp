@@ -179,12 +179,25 @@ bool GraphicsProgram::OnCompile(Device& inDevice)
 
 bool Shader::IsOutOfDate() const 
 {
+    if (mFilePath.empty())
+        return false;
+
     std::error_code error_code;
     fs::file_time_type timestamp = fs::last_write_time(mFilePath, error_code);
-    while (error_code)
+
+    // the file might be locked by an editor that's still saving, the watcher won't report it again so give it a moment.
+    // bounded, unlike spinning on it, and a deleted shader gives up straight away
+    for (int retry = 0; error_code && retry < 50; retry++)
+    {
+        std::error_code exists_error_code;
+        if (!fs::exists(mFilePath, exists_error_code))
+            break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
         timestamp = fs::last_write_time(mFilePath, error_code);
+    }
 
-    return !mFilePath.empty() && mFileTime < timestamp;
+    return !error_code && mFileTime < timestamp;
 }
 
 
@@ -436,16 +449,19 @@ bool SystemShadersDX12::OnHotLoad(Device& inDevice)
 {
     // g_ShaderCompiler.DisableShaderCache();
 
+    // check every program, hot loading is only triggered once per batch of file changes
+    bool hotloaded = false;
+
     for (const auto& member : this->GetRTTI())
     {
         IResource* shader_program = member->Get<IResource>(this);
 
         if (shader_program->OnHotLoad(inDevice))
-            return true;
+            hotloaded = true;
     }
 
     // g_ShaderCompiler.EnableShaderCache();
-    return false;
+    return hotloaded;
 }
 
 
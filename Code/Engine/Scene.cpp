@@ -6,6 +6,7 @@
 #include "Input.h"
 #include "Timer.h"
 #include "Script.h"
+#include "CVars.h"
 #include "Physics.h"
 #include "Profiler.h"
 #include "Threading.h"
@@ -209,9 +210,38 @@ void Scene::UpdateTransforms()
 }
 
 
-void Scene::UpdateStreaming()
+bool Scene::UpdateStreaming()
 {
+	if (!m_StreamingRequest)
+		return false;
+
+	SceneStreamingRequest& request = *m_StreamingRequest;
+	bool swapped = false;
+
+	// swap at the frame boundary, nothing is rendering or updating the live scene right now
+	if (request.GetState() == SceneStreamingRequest::STREAMING_STAGED)
+	{
+		if (request.IsCancelled())
+			request.SetState(SceneStreamingRequest::STREAMING_CANCELLED);
+		else
+		{
+			SwapInStreamingRequest(request);
+			request.SetState(SceneStreamingRequest::STREAMING_UPLOADING);
+			swapped = true;
+		}
+	}
+
+	if (request.GetState() == SceneStreamingRequest::STREAMING_UPLOADING)
+		UploadStreamingRequest(request);
 
+	if (request.GetState() == SceneStreamingRequest::STREAMING_FAILED && request.m_App)
+		request.m_App->LogMessage(request.GetError());
+
+	// release the request (and the old scene's data with it)
+	if (request.IsDone())
+		m_StreamingRequest = nullptr;
+
+	return swapped;
 }
 
 
@@ -273,7 +303,7 @@ void Scene::UpdateNativeScripts(float inDeltaTime)
         {
             if (RTTI* rtti = g_RTTIFactory.GetRTTI(script.type.c_str()))
             {
-                script.script = (INativeScript*)g_RTTIFactory.Construct(script.type.c_str());
+                script.script = (INativeScript*)rtti->Construct();
             }
         }
 	}
@@ -441,24 +471,17 @@ void Scene::LoadMaterialTextures(Assets& inAssets)
 {
 	Timer timer;
 
+	// every texture gets its own load job, textures shared between materials are only loaded once
+	Array<AssetHandle<TextureAsset>> handles;
+
     for (const auto& [entity, material] : Each<Material>())
 	{
-		g_ThreadPool.QueueJob([&, entity]()
-		{
-			Material& material = Get<Material>(entity);
-			inAssets.GetAsset<TextureAsset>(material.albedoFile);
-			inAssets.GetAsset<TextureAsset>(material.normalFile);
-			inAssets.GetAsset<TextureAsset>(material.emissiveFile);
-			inAssets.GetAsset<TextureAsset>(material.metallicFile);
-			inAssets.GetAsset<TextureAsset>(material.roughnessFile);
-
-            //if (m_Renderer)
-              //  m_Renderer->UploadMaterialTextures(entity, material, inAssets);
-		}
-        );
+		for (const String& file : { material.albedoFile, material.normalFile, material.emissiveFile, material.metallicFile, material.roughnessFile })
+			handles.push_back(inAssets.RequestAsset<TextureAsset>(file));
 	}
 
-    g_ThreadPool.WaitForJobs();
+	for (const AssetHandle<TextureAsset>& handle : handles)
+		handle.Wait();
 
 	std::cout << std::format("[Scene] Load textures to RAM took {:.3f} seconds.\n", timer.Restart());
 
@@ -476,131 +499,454 @@ void Scene::LoadMaterialTextures(Assets& inAssets)
 }
 
 
-void Scene::SaveToFile(const String& inFile, Assets& ioAssets, Application* inApp)
+// since version 3 the entity list and hierarchy are stored as tables in the index, so they can live anywhere in the file
+static constexpr uint32_t sEntitiesTableHash = gHash32Bit("RK::Entities");
+static constexpr uint32_t sHierarchyTableHash = gHash32Bit("RK::EntityHierarchy");
+
+
+/* Tracks where every table of the last saved file lives, so the next save to the same file only has to append changed tables. */
+struct SceneSaveState
 {
-	BinaryWriteArchive archive(inFile);
-	File& file = archive.GetFile();
-	
+	struct Table
+	{
+		SceneTable location = {};
+		uint64_t version = 0;
+		const IComponentStorage* storage = nullptr;
+	};
+
+	Path path;
+	uint64_t fileSize = 0;   // anything else on disk means the file was changed by someone else
+	uint64_t indexStart = 0; // the index is always at the end, the next incremental save leaves it behind as dead bytes
+	uint64_t deadBytes = 0;  // bytes of tables that are no longer referenced by the index
+	HashMap<uint32_t, Table> tables;
+};
+
+
+/* Everything that needs to be written for a single save, taken on the main thread. */
+struct SceneSaveSnapshot
+{
+	struct Table
+	{
+		uint32_t hash = 0;
+		uint64_t version = 0;
+		const IComponentStorage* source = nullptr; // live storage, only used to identify it on the next save
+		IComponentStorage* storage = nullptr;	   // what to write, a clone if ownsStorages is set
+	};
+
+	NO_COPY_NO_MOVE(SceneSaveSnapshot);
+	SceneSaveSnapshot() = default;
+
+	~SceneSaveSnapshot()
+	{
+		if (ownsStorages)
+		{
+			for (Table& table : dirtyTables)
+				delete table.storage;
+		}
+	}
+
+	Path path;
+	bool incremental = false;
+	bool ownsStorages = false;
+	Array<Entity> entities;
+	Array<EntityHierarchy::Pair> hierarchy;
+	Array<Table> dirtyTables;
+	Array<SceneTable> cleanTables;
+};
+
+
+/* Never touches what the file's current header points at until everything else made it to disk, a crash mid save leaves the previous save intact.
+   Incremental saves append the changed tables and a new index behind the old one and patch the header last, full saves go through a temporary file. */
+static bool sWriteSaveSnapshot(const SceneSaveSnapshot& inSnapshot, SceneSaveState& ioState)
+{
+	// work on a copy, a failed write shouldn't leave the state pointing at tables that never made it to disk
+	SceneSaveState state = inSnapshot.incremental ? ioState : SceneSaveState();
+
+	Path temp_path = inSnapshot.path;
+	temp_path += ".tmp";
+
+	BinaryWriteArchive archive(inSnapshot.incremental ? inSnapshot.path : temp_path, inSnapshot.incremental ? state.fileSize : 0);
+	ByteBuffer& buffer = archive.GetBuffer();
+
+	if (inSnapshot.incremental)
+	{
+		// the old index stays in the file until the next full save
+		state.deadBytes += state.fileSize - state.indexStart;
+	}
+	else
+	{
+		// jump over the header
+		buffer.Seek(sizeof(SceneHeader));
+	}
+
+	Array<SceneTable> tables = inSnapshot.cleanTables;
+	tables.reserve(tables.size() + inSnapshot.dirtyTables.size() + 2);
+
+	const auto WriteTable = [&](uint32_t inHash, uint64_t inVersion, const IComponentStorage* inStorage, auto&& inWriteFunction)
+	{
+		SceneTable table;
+		table.Hash = inHash;
+		table.Start = buffer.Tell();
+
+		inWriteFunction();
+
+		table.Size = buffer.Tell() - table.Start;
+		tables.push_back(table);
+
+		// the previous copy of this table is no longer referenced
+		SceneSaveState::Table& saved = state.tables[inHash];
+		state.deadBytes += saved.location.Size;
+
+		saved.location = table;
+		saved.version = inVersion;
+		saved.storage = inStorage;
+	};
+
+	// write Entity's
+	WriteTable(sEntitiesTableHash, 0, nullptr, [&]() { WriteFileBinary(buffer, inSnapshot.entities); });
+
+	// write hierarchy
+	WriteTable(sHierarchyTableHash, 0, nullptr, [&]() { WriteFileBinary(buffer, inSnapshot.hierarchy); });
+
+	// write and track dirty tables
+	for (const SceneSaveSnapshot::Table& dirty : inSnapshot.dirtyTables)
+		WriteTable(dirty.hash, dirty.version, dirty.source, [&]() { dirty.storage->Write(archive); });
+
 	SceneHeader header;
 	header.Version = SceneHeader::sVersion;
 	header.MagicNumber = SceneHeader::sMagicNumber;
+	header.IndexTableStart = buffer.Tell();
+	header.IndexTableCount = tables.size();
 
-	// jump over the header
-	file.seekg(sizeof(SceneHeader));
+	// write tables, the file is cut off right after
+	WriteFileBinary(buffer, tables);
 
-	// write Entity's
-	WriteFileBinary(file, m_Entities);
+	state.path = inSnapshot.path;
+	state.fileSize = buffer.Tell();
+	state.indexStart = header.IndexTableStart;
 
-	// write hierarchy
-	Array<EntityHierarchy::Pair> pairs;
-	pairs.reserve(m_Hierarchy.count());
+	if (!inSnapshot.incremental)
+	{
+		// write header (start of the file)
+		buffer.Seek(0);
+		WriteFileBinary(buffer, header);
 
-	for (const EntityHierarchy::Pair& pair : m_Hierarchy)
-		pairs.push_back(pair);
+		if (!archive.Flush())
+			return false;
 
-	WriteFileBinary(file, pairs);
-	
-	// write and track tables
-	Array<SceneTable> tables;
-	tables.reserve(m_Components.size());
+		// replaces the old file in one go, there's never a half written file under the scene's path
+		std::error_code error_code;
+		fs::rename(temp_path, inSnapshot.path, error_code);
+
+		if (error_code)
+		{
+			fs::remove(temp_path, error_code);
+			return false;
+		}
+	}
+	else
+	{
+		if (!archive.Flush())
+			return false;
+
+		// everything the new header points at is on disk now, patching it in place is the only write the old file ever sees
+		std::fstream file(inSnapshot.path, std::ios::binary | std::ios::in | std::ios::out);
+		file.write((const char*)&header, sizeof(header));
+		file.close();
+
+		if (file.fail())
+			return false;
+	}
+
+	ioState = std::move(state);
+	return true;
+}
+
+
+void Scene::CreateSaveSnapshot(SceneSaveSnapshot& ioSnapshot, bool inCloneStorages)
+{
+	PROFILE_FUNCTION_CPU();
+
+	if (!m_SaveState)
+		m_SaveState = std::make_shared<SceneSaveState>();
+
+	const SceneSaveState& state = *m_SaveState;
+
+	// only append if the file on disk is the one we wrote last and it isn't mostly dead space
+	std::error_code error_code;
+	const uint64_t file_size = fs::file_size(ioSnapshot.path, error_code);
+	ioSnapshot.incremental = !error_code && state.path == ioSnapshot.path && state.fileSize == file_size && state.deadBytes < state.fileSize / 2;
+	ioSnapshot.ownsStorages = inCloneStorages;
+
+	ioSnapshot.entities = m_Entities;
+	ioSnapshot.hierarchy.reserve(m_Hierarchy.count());
+
+	for (const EntityHierarchy::Pair& pair : m_Hierarchy)
+		ioSnapshot.hierarchy.push_back(pair);
 
 	for (const auto& [hash, components] : m_Components)
 	{
-		SceneTable table;
-		table.Hash = hash;
-		table.Start = file.tellg();
+		if (ioSnapshot.incremental)
+		{
+			auto saved = state.tables.find(uint32_t(hash));
 
-		components->Write(archive);
+			if (saved != state.tables.end() && saved->second.storage == components && saved->second.version == components->GetVersion())
+			{
+				ioSnapshot.cleanTables.push_back(saved->second.location);
+				continue;
+			}
+		}
 
-		table.Size = uint64_t(file.tellg()) - table.Start;
-		tables.push_back(table);
+		SceneSaveSnapshot::Table& table = ioSnapshot.dirtyTables.emplace_back();
+		table.hash = uint32_t(hash);
+		table.source = components;
+		table.version = components->GetVersion();
+		table.storage = inCloneStorages ? components->Clone() : components;
 	}
+}
 
-	// update header
-	header.IndexTableStart = file.tellg();
-	header.IndexTableCount = tables.size();
 
-	// write tables
-	WriteFileBinary(file, tables);
+void Scene::SaveToFile(const String& inFile, Assets& ioAssets, Application* inApp)
+{
+	PROFILE_FUNCTION_CPU();
+
+	// the save state is shared with any save still in flight
+	if (m_SaveJob)
+		m_SaveJob->WaitCPU();
+
+	m_SaveJob = nullptr;
 
-	// write header (start of the file)
-	file.seekg(0);
-	WriteFileBinary(file, header);
+	SceneSaveSnapshot snapshot;
+	snapshot.path = fs::absolute(inFile).lexically_normal();
+
+	// we block until the write is done, so write straight from the live storages
+	CreateSaveSnapshot(snapshot, false);
+
+	if (!sWriteSaveSnapshot(snapshot, *m_SaveState) && inApp)
+		inApp->LogMessage(std::format("[Scene] Failed to save {}, the file on disk still holds the previous save.", snapshot.path.filename().string()));
+
+	m_ActiveSceneFilePath = inFile;
 }
 
 
-void Scene::OpenFromFile(const String& inFilePath, Assets& ioAssets, Application* inApp)
+Job::Ptr Scene::SaveToFileAsync(const String& inFile, Assets& ioAssets, Application* inApp)
 {
 	PROFILE_FUNCTION_CPU();
 
-	// set file path properties
-	m_ActiveSceneFilePath = inFilePath;
-	assert(fs::is_regular_file(inFilePath));
+	// the save state is shared with any save still in flight
+	if (m_SaveJob)
+		m_SaveJob->WaitCPU();
 
-	if (inApp)
+	Timer timer;
+
+	SharedPtr<SceneSaveSnapshot> snapshot = std::make_shared<SceneSaveSnapshot>();
+	snapshot->path = fs::absolute(inFile).lexically_normal();
+
+	// clone the changed storages so editing can continue while the job writes them out
+	CreateSaveSnapshot(*snapshot, true);
+
+	const float snapshot_time = Timer::sToMilliseconds(timer.GetElapsedTime());
+
+	m_SaveJob = g_ThreadPool.QueueJob([snapshot, state = m_SaveState, inApp, snapshot_time]()
 	{
-		// update Discord status
-		String filename = m_ActiveSceneFilePath.filename().string();
-		inApp->GetDiscordRPC().SetActivityDetails(filename.c_str());
+		Timer timer;
 
-		// clear undo system
-        if (inApp->GetUndo())
-		    inApp->GetUndo()->Clear();
+		if (!sWriteSaveSnapshot(*snapshot, *state))
+		{
+			if (inApp)
+				inApp->LogMessage(std::format("[Scene] Failed to save {}, the file on disk still holds the previous save.", snapshot->path.filename().string()));
+		}
+		else if (inApp)
+		{
+			const size_t table_count = snapshot->dirtyTables.size() + snapshot->cleanTables.size();
+			inApp->LogMessage(std::format("[Scene] Saved {} ({} of {} tables written, {}) in {:.2f} ms (snapshot {:.2f} ms).", 
+				snapshot->path.filename().string(), snapshot->dirtyTables.size(), table_count, snapshot->incremental ? "incremental" : "full", Timer::sToMilliseconds(timer.GetElapsedTime()), snapshot_time));
+		}
+	});
+
+	m_ActiveSceneFilePath = inFile;
+
+	return m_SaveJob;
+}
+
+
+bool Scene::ReadFromFile(const Path& inFile, String& outError, SceneStreamingRequest* ioRequest)
+{
+	PROFILE_FUNCTION_CPU();
+
+	if (!fs::is_regular_file(inFile))
+	{
+		outError = std::format("[Scene] {} is not a file!", inFile.string());
+		return false;
 	}
 
 	// open archive
-	BinaryReadArchive archive(inFilePath);
-	File& file = archive.GetFile();
+	BinaryReadArchive archive(inFile);
+	ByteBuffer& buffer = archive.GetBuffer();
 
 	// read header
 	SceneHeader header;
-	ReadFileBinary(file, header);
+	ReadFileBinary(buffer, header);
 
 	// check for errors
 	if (header.MagicNumber != SceneHeader::sMagicNumber)
 	{
-		if (inApp) 
-			inApp->LogMessage(std::format("[Scene] Magic number mismatch!"));
-		return;
+		outError = "[Scene] Magic number mismatch!";
+		return false;
 	}
-	
-	if (header.Version != SceneHeader::sVersion)
+
+	if (header.Version < SceneHeader::sMinVersion || header.Version > SceneHeader::sVersion)
 	{
-		if (inApp)
-			inApp->LogMessage(std::format("[Scene] Format version mismatch!!"));
-		return;
+		outError = "[Scene] Format version mismatch!!";
+		return false;
 	}
 
 	// clear the current scene
 	Clear();
 	m_Hierarchy.clear();
 
-	// read in Entity's
-	ReadFileBinary(file, m_Entities);
+	archive.SetLegacyTypeNames(header.Version < 4);
+	archive.SetLegacyTypeSchema(header.Version < 5);
+	archive.SetLegacyNestedSchema(header.Version < 6);
+	archive.SetLegacyVariableMembers(header.Version < 7);
 
 	Timer timer;
-	
-	// read in hierarchy
+
+	// read in tables
+	Array<SceneTable> tables;
+	buffer.Seek(header.IndexTableStart);
+	ReadFileBinary(buffer, tables);
+
 	Array<EntityHierarchy::Pair> pairs;
-	ReadFileBinary(file, pairs);
+
+	if (header.Version == 2)
+	{
+		// version 2 stored Entity's and hierarchy right after the header
+		buffer.Seek(sizeof(SceneHeader));
+		ReadFileBinary(buffer, m_Entities);
+		ReadFileBinary(buffer, pairs);
+	}
+	else
+	{
+		for (const SceneTable& table : tables)
+		{
+			buffer.Seek(table.Start);
+
+			if (table.Hash == sEntitiesTableHash)
+				ReadFileBinary(buffer, m_Entities);
+			else if (table.Hash == sHierarchyTableHash)
+				ReadFileBinary(buffer, pairs);
+		}
+	}
+
 	m_Hierarchy.insert(pairs);
 
 	std::cout << std::format("[Scene] Load Hierarchy data took {:.3f} seconds.\n", timer.GetElapsedTime());
 
-	// read in tables
-	Array<SceneTable> tables;
-	file.seekg(header.IndexTableStart);
-	ReadFileBinary(file, tables);
+	if (ioRequest)
+		ioRequest->m_TableCount = uint32_t(tables.size());
+
+	// start tracking the file so the next save only appends what changed
+	SharedPtr<SceneSaveState> save_state = std::make_shared<SceneSaveState>();
+	uint64_t live_bytes = sizeof(SceneHeader) + sizeof(size_t) + tables.size() * sizeof(SceneTable);
 
 	// read in components
 	for (const SceneTable& table : tables)
 	{
-		file.seekg(table.Start);
-		m_Components[table.Hash]->Read(archive);
+		if (ioRequest && ioRequest->IsCancelled())
+			return false;
+
+		if (ioRequest)
+			ioRequest->m_TablesRead++;
+
+		SceneSaveState::Table& saved = save_state->tables[table.Hash];
+		saved.location = table;
+		live_bytes += table.Size;
+
+		if (table.Hash == sEntitiesTableHash || table.Hash == sHierarchyTableHash)
+			continue;
+
+		auto components = m_Components.find(table.Hash);
+		if (components == m_Components.end())
+		{
+			std::cout << std::format("[Scene] Skipping unknown component table {}.\n", table.Hash);
+			continue;
+		}
+
+		buffer.Seek(table.Start);
+		components->second->Read(archive);
+
+		saved.storage = components->second;
+		saved.version = components->second->GetVersion();
 	}
 
 	std::cout << std::format("[Scene] Load ECStorage data took {:.3f} seconds.\n", timer.GetElapsedTime());
 
+	// files from before meshlets existed, or whose Meshlet layout changed since (those are skipped on read), come back without meshlets.
+	// Nothing draws them yet (AddMeshletsRasterPass isn't part of the render graph), this keeps loaded meshes consistent with compiled ones.
+	Timer meshlet_timer;
+	Array<Job::Ptr> meshlet_jobs;
+
+	for (const auto& [entity, mesh] : Each<Mesh>())
+	{
+		if (mesh.meshlets.empty() && !mesh.indices.empty())
+			meshlet_jobs.push_back(g_ThreadPool.QueueJob([&mesh]() { mesh.CalculateMeshlets(); }));
+	}
+
+	// might be called from a streaming job, WaitForJob runs the job itself if no worker got to it yet
+	for (const Job::Ptr& job : meshlet_jobs)
+		g_ThreadPool.WaitForJob(job);
+
+	if (!meshlet_jobs.empty())
+		std::cout << std::format("[Scene] Built meshlets for {} meshes in {:.3f} seconds, they are not saved back to the file.\n", meshlet_jobs.size(), meshlet_timer.GetElapsedTime());
+
+	// version 2 files have no entity and hierarchy tables, let the first save rewrite them in the new format
+	if (header.Version == SceneHeader::sVersion)
+	{
+		std::error_code error_code;
+		save_state->path = fs::absolute(inFile).lexically_normal();
+		save_state->fileSize = fs::file_size(inFile, error_code);
+		save_state->indexStart = header.IndexTableStart;
+		save_state->deadBytes = save_state->fileSize > live_bytes ? save_state->fileSize - live_bytes : 0;
+	}
+
+	m_SaveState = save_state;
+
+	return true;
+}
+
+
+void Scene::OpenFromFile(const String& inFilePath, Assets& ioAssets, Application* inApp)
+{
+	PROFILE_FUNCTION_CPU();
+
+	// a blocking load always wins over whatever was being streamed in
+	CancelStreaming();
+
+	String error;
+	if (!ReadFromFile(inFilePath, error))
+	{
+		if (inApp)
+			inApp->LogMessage(error);
+		return;
+	}
+
+	// set file path properties
+	m_ActiveSceneFilePath = inFilePath;
+
+	if (inApp)
+	{
+		// update Discord status
+		String filename = m_ActiveSceneFilePath.filename().string();
+		inApp->GetDiscordRPC().SetActivityDetails(filename.c_str());
+
+		// clear undo system
+        if (inApp->GetUndo())
+		    inApp->GetUndo()->Clear();
+	}
+
+	Timer timer;
+
 	// load material texture data to vram
 	LoadMaterialTextures(ioAssets);
 
@@ -612,6 +958,7 @@ void Scene::OpenFromFile(const String& inFilePath, Assets& ioAssets, Application
 		if (TextureAsset::Ptr asset = ioAssets.GetAsset<TextureAsset>(light.cubeMapFile))
 		{
 			light.cubeMap = m_Renderer->UploadTextureFromAsset(asset);
+			light.cubeMapAsset = asset;
 			m_Renderer->OnResize(inApp->GetViewport());
 		}
 	}
@@ -635,9 +982,11 @@ void Scene::OpenFromFile(const String& inFilePath, Assets& ioAssets, Application
 
 	for (const auto& [entity, script] : Each<NativeScript>())
 	{
-		if (ScriptAsset::Ptr asset = ioAssets.GetAsset<ScriptAsset>(script.file))
+		script.asset = ioAssets.GetAsset<ScriptAsset>(script.file);
+
+		if (script.asset)
 		{
-			for (const String& type_str : asset->GetRegisteredTypes())
+			for (const String& type_str : script.asset->GetRegisteredTypes())
 			{
 				script.types.push_back(type_str);
 			}
@@ -660,131 +1009,204 @@ void Scene::OpenFromFile(const String& inFilePath, Assets& ioAssets, Application
 }
 
 
-void Scene::OpenFromFileAsync(const String& inFilePath, Assets& ioAssets, Application* inApp)
+SceneStreamingRequest::Ptr Scene::OpenFromFileAsync(const String& inFilePath, Assets& ioAssets, Application* inApp)
 {
 	PROFILE_FUNCTION_CPU();
 
-	// set file path properties
-	m_ActiveSceneFilePath = inFilePath;
-	assert(fs::is_regular_file(inFilePath));
-
-	// open archive
-	BinaryReadArchive archive(inFilePath);
-	File& file = archive.GetFile();
+	// only one scene can be streamed in at a time
+	CancelStreaming();
 
-	// read header
-	SceneHeader header;
-	ReadFileBinary(file, header);
+	SceneStreamingRequest::Ptr request = std::make_shared<SceneStreamingRequest>(inFilePath, ioAssets, inApp);
+	m_StreamingRequest = request;
 
-	// check for errors
-	if (header.MagicNumber != SceneHeader::sMagicNumber)
+	// the job keeps the request (and thus the staging scene) alive, the live scene is never touched from here
+	g_ThreadPool.QueueJob([request]()
 	{
-		if (inApp)
-			inApp->LogMessage(std::format("[Scene] Magic number mismatch!"));
+		if (request->IsCancelled())
+		{
+			request->SetState(SceneStreamingRequest::STREAMING_CANCELLED);
+			return;
+		}
+
+		request->SetState(SceneStreamingRequest::STREAMING_READING);
+
+		Scene& staging = *request->m_Staging;
+
+		String error;
+		if (!staging.ReadFromFile(request->m_Path, error, request.get()))
+		{
+			if (request->IsCancelled())
+				request->SetState(SceneStreamingRequest::STREAMING_CANCELLED);
+			else
+				request->Fail(error);
+
+			return;
+		}
+
+		// every material is loaded to RAM and uploaded, every mesh is uploaded
+		request->m_StepCount = uint32_t(2 * staging.Count<Material>() + staging.Count<Mesh>());
+
+		// load texture data to RAM in parallel, the main thread uploads them as they finish
+		for (const auto& [entity, material] : staging.Each<Material>())
+		{
+			StaticArray<String, 5> files = { material.albedoFile, material.normalFile, material.emissiveFile, material.metallicFile, material.roughnessFile };
+
+			request->m_TextureJobs.emplace_back(entity, g_ThreadPool.QueueJob([request, files]()
+			{
+				if (!request->IsCancelled())
+				{
+					for (const String& file : files)
+						request->m_Assets.GetAsset<TextureAsset>(file);
+				}
+
+				request->m_StepsDone++;
+			}));
+		}
+
+		for (const auto& [entity, mesh] : staging.Each<Mesh>())
+			request->m_PendingMeshes.push_back(entity);
+
+		request->SetState(SceneStreamingRequest::STREAMING_STAGED);
+	});
+
+	return request;
+}
+
+
+void Scene::CancelStreaming()
+{
+	if (!m_StreamingRequest)
 		return;
-	}
 
-	if (header.Version != SceneHeader::sVersion)
+	// too late to cancel, the live scene was already replaced so its uploads have to land before anything else touches it
+	if (!m_StreamingRequest->Cancel())
 	{
-		if (inApp)
-			inApp->LogMessage(std::format("[Scene] Format version mismatch!!"));
-		return;
+		SceneStreamingRequest& request = *m_StreamingRequest;
+
+		for (const auto& [entity, job] : request.m_TextureJobs)
+			g_ThreadPool.WaitForJob(job);
+
+		while (request.GetState() == SceneStreamingRequest::STREAMING_UPLOADING)
+			UploadStreamingRequest(request);
 	}
 
-	// clear the current scene
-	Clear();
-	m_Hierarchy.clear();
+	m_StreamingRequest = nullptr;
+}
 
-	// read in Entity's
-	ReadFileBinary(file, m_Entities);
 
-	Timer timer;
+void Scene::SwapInStreamingRequest(SceneStreamingRequest& ioRequest)
+{
+	Scene& staging = *ioRequest.m_Staging;
 
-	// read in hierarchy
-	Array<EntityHierarchy::Pair> pairs;
-	ReadFileBinary(file, pairs);
-	m_Hierarchy.insert(pairs);
+	// the old scene's data ends up in the staging scene and is destroyed together with the request
+	Swap(staging);
+	std::swap(m_Hierarchy, staging.m_Hierarchy);
+	std::swap(m_RootEntity, staging.m_RootEntity);
+	std::swap(m_SaveState, staging.m_SaveState);
 
-	std::cout << std::format("[Scene] Load Hierarchy data took {:.3f} seconds.\n", timer.GetElapsedTime());
+	m_ActiveSceneFilePath = ioRequest.m_Path;
 
-	// read in tables
-	Array<SceneTable> tables;
-	file.seekg(header.IndexTableStart);
-	ReadFileBinary(file, tables);
+	Application* app = ioRequest.m_App;
+	Assets& assets = ioRequest.m_Assets;
 
-	// read in components
-	for (const SceneTable& table : tables)
+	if (app)
 	{
-		file.seekg(table.Start);
-		m_Components[table.Hash]->Read(archive);
+		// update Discord status
+		String filename = m_ActiveSceneFilePath.filename().string();
+		app->GetDiscordRPC().SetActivityDetails(filename.c_str());
+
+		// clear undo system
+		if (app->GetUndo())
+			app->GetUndo()->Clear();
 	}
 
-	std::cout << std::format("[Scene] Load ECStorage data took {:.3f} seconds.\n", timer.GetElapsedTime());
+	for (const auto& [entity, light] : Each<DirectionalLight>())
+	{
+		if (light.cubeMapFile.empty() || !m_Renderer)
+			continue;
 
-    for (const auto& [entity, script] : Each<NativeScript>())
-    {
-        if (ScriptAsset::Ptr asset = ioAssets.GetAsset<ScriptAsset>(script.file))
-        {
-            for (const String& type_str : asset->GetRegisteredTypes())
-            {
-                script.types.push_back(type_str);
-            }
+		if (TextureAsset::Ptr asset = assets.GetAsset<TextureAsset>(light.cubeMapFile))
+		{
+			light.cubeMap = m_Renderer->UploadTextureFromAsset(asset);
+			light.cubeMapAsset = asset;
 
-            if (inApp)
-            {
-                BindScriptToEntity(entity, script, inApp);
-                continue;
-            }
-        }
+			if (app)
+				m_Renderer->OnResize(app->GetViewport());
+		}
+	}
 
-        if (!script.type.empty())
-        {
-            if (inApp)
-                BindScriptToEntity(entity, script, inApp);
-        }
-    }
+	for (const auto& [entity, script] : Each<NativeScript>())
+	{
+		bool has_asset = false;
 
-	timer.Restart();
+		script.asset = assets.GetAsset<ScriptAsset>(script.file);
 
-	// load mesh data to RAM and schedule VRAM uploads
-	g_ThreadPool.QueueJob([this]() 
-	{
-		for (const auto& [entity, mesh] : Each<Mesh>())
+		if (script.asset)
 		{
-			if (m_Renderer)
-				m_Renderer->UploadMeshBuffers(entity, mesh);
+			for (const String& type_str : script.asset->GetRegisteredTypes())
+				script.types.push_back(type_str);
 
-			if (Skeleton* skeleton = GetPtr<Skeleton>(entity))
-				m_Renderer->UploadSkeletonBuffers(entity, *skeleton, mesh);
+			has_asset = true;
 		}
-	});
 
-	Job::Barrier barrier = Job::Barrier(Count<Material>());
+		if (app && ( has_asset || !script.type.empty() ))
+			BindScriptToEntity(entity, script, app);
+	}
 
-	// load textures data to RAM
-	for (const auto& [entity, material] : Each<Material>())
+	std::cout << std::format("[Scene] Staging {} took {:.3f} seconds.\n", ioRequest.m_Path.string(), ioRequest.m_Timer.Restart());
+}
+
+
+void Scene::UploadStreamingRequest(SceneStreamingRequest& ioRequest)
+{
+	PROFILE_FUNCTION_CPU();
+
+	static float& budget_ms = g_CVariables->Create("streaming_budget_ms", 4.0f);
+
+	Timer timer;
+	const auto IsOverBudget = [&]() { return Timer::sToMilliseconds(timer.GetElapsedTime()) > budget_ms; };
+
+	// upload mesh buffers, these are already in RAM as part of the scene file
+	while (ioRequest.m_NextMesh < ioRequest.m_PendingMeshes.size() && !IsOverBudget())
 	{
-		barrier.AddJob(g_ThreadPool.QueueJob([&]()
-		{
-			ioAssets.GetAsset<TextureAsset>(material.albedoFile);
-			ioAssets.GetAsset<TextureAsset>(material.normalFile);
-			ioAssets.GetAsset<TextureAsset>(material.emissiveFile);
-			ioAssets.GetAsset<TextureAsset>(material.metallicFile);
-			ioAssets.GetAsset<TextureAsset>(material.roughnessFile);
-		}));
+		Entity entity = ioRequest.m_PendingMeshes[ioRequest.m_NextMesh++];
+		ioRequest.m_StepsDone++;
+
+		Mesh* mesh = GetPtr<Mesh>(entity);
+		if (!mesh || !m_Renderer)
+			continue;
+
+		m_Renderer->UploadMeshBuffers(entity, *mesh);
+
+		if (Skeleton* skeleton = GetPtr<Skeleton>(entity))
+			m_Renderer->UploadSkeletonBuffers(entity, *skeleton, *mesh);
 	}
 
-	if (m_Renderer)
+	// upload material textures whose data finished loading to RAM
+	for (auto it = ioRequest.m_TextureJobs.begin(); it != ioRequest.m_TextureJobs.end() && !IsOverBudget(); )
 	{
-		g_ThreadPool.QueueJob([this, &ioAssets, barrier]() 
+		const auto& [entity, job] = *it;
+		if (!job->IsFinished())
 		{
-			barrier.Wait();
+			it++;
+			continue;
+		}
 
-			for (const auto& [entity, material] : Each<Material>())
-			{
-				m_Renderer->UploadMaterialTextures(entity, material, ioAssets);
-			}
-		});
+		if (Material* material = GetPtr<Material>(entity))
+		{
+			if (m_Renderer)
+				m_Renderer->UploadMaterialTextures(entity, *material, ioRequest.m_Assets);
+		}
+
+		ioRequest.m_StepsDone++;
+		it = ioRequest.m_TextureJobs.erase(it);
+	}
+
+	if (ioRequest.m_NextMesh == ioRequest.m_PendingMeshes.size() && ioRequest.m_TextureJobs.empty())
+	{
+		ioRequest.SetState(SceneStreamingRequest::STREAMING_FINISHED);
+
+		std::cout << std::format("[Scene] Upload of {} took {:.3f} seconds.\n", ioRequest.m_Path.string(), ioRequest.m_Timer.GetElapsedTime());
 	}
 }
 
@@ -832,6 +1254,18 @@ void Scene::Optimize()
 }
 
 
+void Importer::ProcessMesh(Mesh& ioMesh, bool inSkinned)
+{
+	const bool optimize_meshes = g_CVariables ? g_CVariables->Create("optimize_meshes", 1) : true;
+
+	if (optimize_meshes && !inSkinned)
+		ioMesh.Optimize();
+
+	// built from the final vertex order, meshlets index into the vertex buffer
+	ioMesh.CalculateMeshlets();
+}
+
+
 bool SceneImporter::LoadFromFile(const String& inFile, Assets* inAssets)
 {
 	/*
@@ -975,4 +1409,83 @@ void SceneImporter::ConvertMaterial(Entity inEntity, const Material& inMaterial)
 	material.gpuRoughnessMap = 0;
 }
 
+SceneStreamingRequest::SceneStreamingRequest(const Path& inPath, Assets& inAssets, Application* inApp) :
+	m_Path(inPath), m_Assets(inAssets), m_App(inApp), m_Staging(std::make_unique<Scene>(nullptr))
+{
+}
+
+
+SceneStreamingRequest::~SceneStreamingRequest()
+{
+}
+
+
+bool SceneStreamingRequest::Cancel()
+{
+	// once swapped in the live scene has already been replaced, let the uploads finish
+	if (GetState() >= STREAMING_UPLOADING)
+		return false;
+
+	m_Cancelled = true;
+	return true;
+}
+
+
+float SceneStreamingRequest::GetProgress() const
+{
+	switch (GetState())
+	{
+		case STREAMING_QUEUED:
+			return 0.0f;
+		case STREAMING_READING:
+		{
+			const uint32_t table_count = m_TableCount.load();
+			return table_count ? 0.5f * float(m_TablesRead.load()) / table_count : 0.0f;
+		}
+		case STREAMING_STAGED:
+		case STREAMING_UPLOADING:
+		{
+			const uint32_t step_count = m_StepCount.load();
+			return step_count ? 0.5f + 0.5f * float(m_StepsDone.load()) / step_count : 0.5f;
+		}
+		default:
+			return 1.0f;
+	}
+}
+
+
+void RunSceneSaveTests()
+{
+	const Path file = fs::temp_directory_path() / "RaekorSceneSaveTest.scene";
+	Assets assets;
+
+	Scene scene(nullptr);
+	const Entity entity = scene.Create();
+	scene.Add<Name>(entity).name = "Entity";
+	scene.Add<Transform>(entity);
+
+	scene.SaveToFile(file.string(), assets);
+
+	// edit in place through plain access, the incremental save below has to pick both up without anyone calling MarkDirty
+	scene.Get<Transform>(entity).position = Vec3(1.0f, 2.0f, 3.0f);
+
+	for (const auto& [entity, name] : scene.Each<Name>())
+		name.name = "EditedEntity";
+
+	scene.SaveToFile(file.string(), assets);
+
+	String error;
+	Scene loaded_scene(nullptr);
+	const bool loaded = loaded_scene.ReadFromFile(file, error);
+	assert(loaded);
+
+	const Scene& const_scene = loaded_scene;
+	assert(const_scene.Has<Transform>(entity) && const_scene.Has<Name>(entity));
+	assert(const_scene.Get<Transform>(entity).position == Vec3(1.0f, 2.0f, 3.0f));
+	assert(const_scene.Get<Name>(entity).name == "EditedEntity");
+
+	std::error_code error_code;
+	fs::remove(file, error_code);
+}
+
 } // RK
\ No newline at end of file
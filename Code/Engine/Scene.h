@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ecs.h"
+#include "timer.h"
 #include "defines.h"
+#include "threading.h"
 
 namespace RK {
 
@@ -11,6 +13,10 @@ class Application;
 class NativeScript;
 class SceneImporter;
 class IRenderInterface;
+class SceneStreamingRequest;
+
+struct SceneSaveState;
+struct SceneSaveSnapshot;
 
 struct Mesh;
 struct Material;
@@ -37,7 +43,7 @@ public:
 	// Per frame systems
 	void UpdateLights();
 	void UpdateCameras();
-	void UpdateStreaming();
+	bool UpdateStreaming(); // true if a streamed in scene replaced the live one this frame
 	void UpdateTransforms();
 	void UpdateAnimations(float inDeltaTime);
 	void UpdateNativeScripts(float inDeltaTime);
@@ -69,10 +75,24 @@ public:
 	// load materials from disk in parallel, is used for both importing and scene loading.
 	void LoadMaterialTextures(Assets& ioAssets);
 
-	// save Scene to disk
+	// save Scene to disk, only component tables that changed since the last save to the same file are rewritten
 	void SaveToFile(const String& inFile, Assets& ioAssets, Application* inApp = nullptr);
+
+	// snapshots the changed tables on the calling thread and writes them to disk on a job thread
+	Job::Ptr SaveToFileAsync(const String& inFile, Assets& ioAssets, Application* inApp = nullptr);
 	void OpenFromFile(const String& inFile, Assets& ioAssets, Application* inApp = nullptr);
-	void OpenFromFileAsync(const String& inFile, Assets& ioAssets, Application* inApp = nullptr);
+
+	// stream a Scene in from disk, the live scene is swapped out in UpdateStreaming at the start of a frame
+	SharedPtr<SceneStreamingRequest> OpenFromFileAsync(const String& inFile, Assets& ioAssets, Application* inApp = nullptr);
+	SharedPtr<SceneStreamingRequest> GetStreamingRequest() const { return m_StreamingRequest; }
+	/* Drops the active request if it can still be cancelled, otherwise blocks until its remaining uploads are done. */
+	void CancelStreaming();
+
+	// read entities, hierarchy and component tables from disk into this scene, no GPU uploads
+	bool ReadFromFile(const Path& inFile, String& outError, SceneStreamingRequest* ioRequest = nullptr);
+
+	const Path& GetActiveSceneFilePath() const { return m_ActiveSceneFilePath; }
+	void SetActiveSceneFilePath(const Path& inPath) { m_ActiveSceneFilePath = inPath; }
 
 	// script utilities
 	void BindScriptToEntity(Entity inEntity, NativeScript& inScript, Application* inApp);
@@ -81,8 +101,16 @@ public:
 protected:
 	Path m_ActiveSceneFilePath;
 	IRenderInterface* m_Renderer;
+	SharedPtr<SceneStreamingRequest> m_StreamingRequest;
+
+	Job::Ptr m_SaveJob;
+	SharedPtr<SceneSaveState> m_SaveState;
 	
 private:
+	void CreateSaveSnapshot(SceneSaveSnapshot& ioSnapshot, bool inCloneStorages);
+	void SwapInStreamingRequest(SceneStreamingRequest& ioRequest);
+	void UploadStreamingRequest(SceneStreamingRequest& ioRequest);
+
 	Entity m_RootEntity;
 	std::stack<Entity> m_DFS;
 	std::queue<Entity> m_BFS;
@@ -90,15 +118,87 @@ private:
 };
 
 
+class SceneStreamingRequest
+{
+	friend class Scene;
+
+public:
+	using Ptr = SharedPtr<SceneStreamingRequest>;
+
+	enum EState
+	{
+		STREAMING_QUEUED,	 // waiting for a job thread
+		STREAMING_READING,	 // reading component tables into the staging scene
+		STREAMING_STAGED,	 // waiting for the next frame boundary to swap with the live scene
+		STREAMING_UPLOADING, // swapped in, uploading meshes and textures under a per-frame time budget
+		STREAMING_FINISHED,
+		STREAMING_CANCELLED,
+		STREAMING_FAILED
+	};
+
+	SceneStreamingRequest(const Path& inPath, Assets& inAssets, Application* inApp);
+	~SceneStreamingRequest();
+
+	/* Cancellation is only honored up until the staged data is swapped into the live scene. Returns false if it was too late. */
+	bool Cancel();
+	bool IsCancelled() const { return m_Cancelled.load(); }
+
+	EState GetState() const { return m_State.load(); }
+	bool IsDone() const { return GetState() >= STREAMING_FINISHED; }
+	bool HasError() const { return GetState() == STREAMING_FAILED; }
+
+	/* Only valid once HasError() returns true. */
+	const String& GetError() const { return m_Error; }
+	const Path& GetPath() const { return m_Path; }
+
+	/* Returns progress in the range [0, 1]. Reading accounts for the first half, texture loads and uploads for the second. */
+	float GetProgress() const;
+
+private:
+	void SetState(EState inState) { m_State.store(inState); }
+	void Fail(const String& inError) { m_Error = inError; SetState(STREAMING_FAILED); }
+
+	Path m_Path;
+	String m_Error;
+	Timer m_Timer;
+	Assets& m_Assets;
+	Application* m_App = nullptr;
+	UniquePtr<Scene> m_Staging;
+
+	Atomic<EState> m_State = STREAMING_QUEUED;
+	Atomic<bool> m_Cancelled = false;
+
+	Atomic<uint32_t> m_TableCount = 0;
+	Atomic<uint32_t> m_TablesRead = 0;
+	Atomic<uint32_t> m_StepCount = 0;
+	Atomic<uint32_t> m_StepsDone = 0;
+
+	// filled in by the reading job before the request is staged, only touched by the main thread after that
+	Array<Pair<Entity, Job::Ptr>> m_TextureJobs;
+	Array<Entity> m_PendingMeshes;
+	size_t m_NextMesh = 0;
+};
+
+
 class Importer
 {
 public:
 	Importer(Scene& inScene, IRenderInterface* inRenderer) : m_Scene(inScene), m_Renderer(inRenderer) {}
 	virtual bool LoadFromFile(const String& inFile, Assets* inAssets) = 0;
 
+	/* Files besides inFile that LoadFromFile read from (e.g. GLTF buffers or OBJ material libraries), the output depends on their content too. */
+	const Array<String>& GetFileDependencies() const { return m_FileDependencies; }
+
 protected:
+	void AddFileDependency(const Path& inFile) { m_FileDependencies.push_back(inFile.lexically_normal().string()); }
+
+	/* Meshes imported straight into the editor skip the asset compiler, call this before uploading them so they get the same vertex cache optimization
+		(if the optimize_meshes cvar is on) and meshlet data as compiled meshes, no render pass reads the meshlets yet. Skinned meshes aren't optimized, their bone weights are converted after the mesh and have to keep its vertex order. */
+	void ProcessMesh(Mesh& ioMesh, bool inSkinned);
+
 	Scene& m_Scene;
 	IRenderInterface* m_Renderer = nullptr;
+	Array<String> m_FileDependencies;
 };
 
 
@@ -120,4 +220,8 @@ private:
 	HashMap<Entity, Entity> m_MaterialMapping;
 };
 
+
+/* Saves, edits, saves again and reloads a small scene to check that in place edits make it into incremental saves. */
+void RunSceneSaveTests();
+
 } // Namespace Raekor
\ No newline at end of file
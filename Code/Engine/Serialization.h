@@ -19,7 +19,8 @@ enum ECompressionType
 
 struct SceneHeader
 {
-	static constexpr uint32_t sVersion = 2;
+	static constexpr uint32_t sVersion = 7;
+	static constexpr uint32_t sMinVersion = 2; // oldest version that can still be read
 	static constexpr uint64_t sMagicNumber = 'RKSC';
 
 	uint32_t Version;
@@ -36,135 +37,368 @@ struct SceneTable
 };
 
 
+/* Contiguous in-memory byte stream with a cursor, all binary serialization goes through this so every read or write is a plain memcpy. */
+class ByteBuffer
+{
+public:
+	ByteBuffer() = default;
+	ByteBuffer(Array<uint8_t>&& inData, uint64_t inOffset = 0) : m_Offset(inOffset), m_Data(std::move(inData)) {}
+
+	void Read(void* outData, size_t inSize)
+	{
+		// never read past the end, missing bytes are left untouched like a failed stream read would
+		const size_t size = m_Position < m_Data.size() ? std::min(inSize, m_Data.size() - m_Position) : 0;
+		std::memcpy(outData, m_Data.data() + m_Position, size);
+		m_Position += size;
+	}
+
+	void Write(const void* inData, size_t inSize)
+	{
+		if (m_Position + inSize > m_Data.size())
+			m_Data.resize(m_Position + inSize);
+
+		std::memcpy(m_Data.data() + m_Position, inData, inSize);
+		m_Position += inSize;
+	}
+
+	void Reserve(size_t inSize) { m_Data.reserve(inSize); }
+
+	/* Positions are absolute, a buffer can start at an offset into the file it was read from or will be written to. */
+	void Seek(uint64_t inPosition) { assert(inPosition >= m_Offset); m_Position = size_t(inPosition - m_Offset); }
+	uint64_t Tell() const { return m_Offset + m_Position; }
+
+	// skipping past the end clamps to the end, same as Read. Written so that huge sizes (SIZE_MAX or a corrupt count) can't wrap around
+	void Skip(size_t inSize) { m_Position += m_Position < m_Data.size() ? std::min(inSize, m_Data.size() - m_Position) : 0; }
+
+	bool IsEOF() const { return m_Position >= m_Data.size(); }
+	uint64_t GetOffset() const { return m_Offset; }
+
+	const Array<uint8_t>& GetData() const { return m_Data; }
+
+private:
+	uint64_t m_Offset = 0;
+	size_t m_Position = 0;
+	Array<uint8_t> m_Data;
+};
+
+
 template<typename T>
-void ReadFileData(File& ioFile, T& ioData) { ioFile.read((char*)&ioData, sizeof(T)); }
+void ReadFileData(ByteBuffer& ioBuffer, T& ioData) { ioBuffer.Read(&ioData, sizeof(T)); }
 template<typename T>
-inline void WriteFileData(File& ioFile, const T& inData) { ioFile.write((const char*)&inData, sizeof(T)); }
+inline void WriteFileData(ByteBuffer& ioBuffer, const T& inData) { ioBuffer.Write(&inData, sizeof(T)); }
 
 
 template<typename T>
-void WriteFileSlice(File& ioFile, Slice<T> inData) { ioFile.write((const char*)inData.data(), inData.size() * sizeof(T)); }
+void WriteFileSlice(ByteBuffer& ioBuffer, Slice<T> inData) { ioBuffer.Write(inData.data(), inData.size_bytes()); }
 template<typename T>
-void ReadFileSlice(File& ioFile, Slice<T> inData) { ioFile.read((char*)inData.data(), inData.size() * sizeof(T)); }
+void ReadFileSlice(ByteBuffer& ioBuffer, Slice<T> inData) { ioBuffer.Read(inData.data(), inData.size_bytes()); }
 
 
 template<typename T>
-inline void WriteFileBinary(File& ioFile, const T& inData) { WriteFileData(ioFile, inData); }
+inline void WriteFileBinary(ByteBuffer& ioBuffer, const T& inData) { WriteFileData(ioBuffer, inData); }
 template<typename T>
-inline void ReadFileBinary(File& ioFile, T& ioData) { ReadFileData(ioFile, ioData); }
+inline void ReadFileBinary(ByteBuffer& ioBuffer, T& ioData) { ReadFileData(ioBuffer, ioData); }
 
 
-inline void ReadFileBinary(File& ioFile, Path& ioData)
+inline void ReadFileBinary(ByteBuffer& ioBuffer, Path& ioData)
 {
 	std::string value;
-	ReadFileBinary(ioFile, value);
+	ReadFileBinary(ioBuffer, value);
 	ioData = std::move(value);
 }
-inline void WriteFileBinary(File& ioFile, const Path& inData)
+inline void WriteFileBinary(ByteBuffer& ioBuffer, const Path& inData)
 {
-	WriteFileBinary(ioFile, inData.string());
+	WriteFileBinary(ioBuffer, inData.string());
 }
 
 
-inline void ReadFileBinary(File& ioFile, std::string& ioData)
+inline void ReadFileBinary(ByteBuffer& ioBuffer, std::string& ioData)
 {
 	size_t size = 0;
-	ReadFileData(ioFile, size);
+	ReadFileData(ioBuffer, size);
 	ioData.resize(size);
-	ReadFileSlice(ioFile, Slice<char>(ioData));
+	ReadFileSlice(ioBuffer, Slice<char>(ioData));
 }
-inline void WriteFileBinary(File& ioFile, const std::string& inData)
+inline void WriteFileBinary(ByteBuffer& ioBuffer, const std::string& inData)
 {
-	WriteFileData(ioFile, inData.size());
-	WriteFileSlice(ioFile, std::as_bytes(Slice(inData)));
+	WriteFileData(ioBuffer, inData.size());
+	WriteFileSlice(ioBuffer, std::as_bytes(Slice(inData)));
 }
 
 
 template<typename T>
-inline void WriteFileBinary(File& ioFile, const std::vector<T>& inData)
+inline void WriteFileBinary(ByteBuffer& ioBuffer, const std::vector<T>& inData)
 {
 	auto size = inData.size();
-	WriteFileData(ioFile, size);
+	WriteFileData(ioBuffer, size);
 
 	if constexpr (std::is_trivially_copyable_v<T>)
 	{
-		WriteFileSlice(ioFile, Slice(inData));
+		WriteFileSlice(ioBuffer, Slice(inData));
 	}
 	else
 	{
 		for (size_t i = 0; i < size; i++)
-			WriteFileBinary(ioFile, inData[i]);
+			WriteFileBinary(ioBuffer, inData[i]);
 	}
 }
 
 
 template<typename K, typename V>
-inline void WriteFileBinary(File& ioFile, const std::unordered_map<K, V>& inData)
+inline void WriteFileBinary(ByteBuffer& ioBuffer, const std::unordered_map<K, V>& inData)
 {
 	auto size = inData.size();
-	WriteFileBinary(ioFile, size);
+	WriteFileBinary(ioBuffer, size);
 
 	for (const auto& [key, value] : inData)
 	{
-		WriteFileBinary(ioFile, key);
-		WriteFileBinary(ioFile, value);
+		WriteFileBinary(ioBuffer, key);
+		WriteFileBinary(ioBuffer, value);
 	}
 }
 
 
 template<typename K, typename V>
-inline void ReadFileBinary(File& ioFile, std::unordered_map<K, V>& inData)
+inline void ReadFileBinary(ByteBuffer& ioBuffer, std::unordered_map<K, V>& inData)
 {
 	size_t size = 0;
-	ReadFileBinary(ioFile, size);
+	ReadFileBinary(ioBuffer, size);
 
 	for (size_t i = 0; i < size; i++)
 	{
 		K key;
-		ReadFileBinary(ioFile, key);
-		ReadFileBinary(ioFile, inData[key]);
+		ReadFileBinary(ioBuffer, key);
+		ReadFileBinary(ioBuffer, inData[key]);
 	}
 }
 
 template<typename T>
-inline void ReadFileBinary(File& ioFile, std::vector<T>& ioData)
+inline void ReadFileBinary(ByteBuffer& ioBuffer, std::vector<T>& ioData)
 {
 	size_t size = 0;
-	ReadFileData(ioFile, size);
+	ReadFileData(ioBuffer, size);
 	ioData.resize(size);
 
 	if constexpr (std::is_trivially_copyable_v<T>)
 	{
-		ReadFileSlice(ioFile, Slice(ioData));
+		ReadFileSlice(ioBuffer, Slice(ioData));
 	}
 	else
 	{
 		for (size_t i = 0; i < size; i++)
-			ReadFileBinary(ioFile, ioData[i]);
+			ReadFileBinary(ioBuffer, ioData[i]);
 	}
 }
 
 template<typename T>
 concept HasRTTI = requires ( T t ) { t.GetRTTI(); };
 
+/* Types that list their binary members with RTTI_DECLARE_SERIALIZER get fully inlined reads and writes instead of a virtual call per member. */
+template<typename T>
+concept HasSerializer = requires { T::sGetSerializedMembers(); };
+
 template<typename T> requires HasRTTI<T>
-inline void ReadFileBinary(File& ioFile, T& ioData)
+inline void ReadFileBinary(ByteBuffer& ioBuffer, T& ioData)
 {
 	auto& rtti = RTTI_OF<T>();
-	for (const auto& member : rtti)
+
+	if constexpr (std::is_trivially_copyable_v<T>)
 	{
-		if (member->GetSerializeType() & SERIALIZE_BINARY)
-			member->FromBinary(ioFile, &ioData);
+		if (rtti.IsTriviallySerializable())
+			return ReadFileData(ioBuffer, ioData);
+	}
+
+	// the member list is checked against the RTTI once when the type is defined, see gValidateSerializer
+	if constexpr (HasSerializer<T>)
+	{
+		std::apply([&](auto... inMembers) { ( ReadFileBinary(ioBuffer, ioData.*inMembers), ... ); }, T::sGetSerializedMembers());
+	}
+	else
+	{
+		for (const auto& member : rtti)
+		{
+			if (member->GetSerializeType() & SERIALIZE_BINARY)
+				member->FromBinary(ioBuffer, &ioData);
+		}
 	}
 }
 template<typename T> requires HasRTTI<T>
-inline void WriteFileBinary(File& ioFile, const T& inData)
+inline void WriteFileBinary(ByteBuffer& ioBuffer, const T& inData)
 {
 	auto& rtti = RTTI_OF<T>();
-	for (const auto& member : rtti)
+
+	if constexpr (std::is_trivially_copyable_v<T>)
+	{
+		if (rtti.IsTriviallySerializable())
+			return WriteFileData(ioBuffer, inData);
+	}
+
+	// the member list is checked against the RTTI once when the type is defined, see gValidateSerializer
+	if constexpr (HasSerializer<T>)
+	{
+		std::apply([&](auto... inMembers) { ( WriteFileBinary(ioBuffer, inData.*inMembers), ... ); }, T::sGetSerializedMembers());
+	}
+	else
+	{
+		for (const auto& member : rtti)
+		{
+			if (member->GetSerializeType() & SERIALIZE_BINARY)
+				member->ToBinary(ioBuffer, &inData);
+		}
+	}
+}
+
+/* How a value ends up in a binary stream, enough to skip over it without knowing its type. Matches the Write/ReadFileBinary overloads above. */
+struct BinaryLayout
+{
+	enum EKind : uint32_t
+	{
+		FIXED,      // size bytes
+		ARRAY,      // size_t count followed by count elements of size bytes (strings, arrays of trivially copyable types)
+		VARIABLE    // anything else, can only be read by the type itself
+	};
+
+	EKind kind = VARIABLE;
+	uint32_t size = 0;
+	uint32_t schema = 0; // gGetSchemaHash of the RTTI type stored in here (directly, as array elements or map values), 0 if there is none
+
+	bool operator==(const BinaryLayout& inOther) const = default;
+};
+
+class RTTI;
+
+/* Hash of the binary member names and layouts of inRTTI, including those of nested RTTI types. 
+   Catches a nested type changing while the layout of the member holding it stays the same. */
+uint32_t gGetSchemaHash(const RTTI& inRTTI);
+
+template<typename T>
+struct IsVector : std::false_type {};
+template<typename T>
+struct IsVector<std::vector<T>> : std::true_type {};
+
+template<typename T>
+struct IsMap : std::false_type {};
+template<typename K, typename V>
+struct IsMap<std::unordered_map<K, V>> : std::true_type {};
+
+template<typename T>
+inline BinaryLayout gGetBinaryLayout()
+{
+	if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, Path>)
+		return { BinaryLayout::ARRAY, 1 };
+	else if constexpr (IsVector<T>::value)
+	{
+		const uint32_t schema = gGetBinaryLayout<typename T::value_type>().schema;
+
+		if constexpr (std::is_trivially_copyable_v<typename T::value_type>)
+			return { BinaryLayout::ARRAY, uint32_t(sizeof(typename T::value_type)), schema };
+		else
+			return { BinaryLayout::VARIABLE, 0, schema };
+	}
+	else if constexpr (IsMap<T>::value)
+	{
+		const uint32_t key_schema = gGetBinaryLayout<typename T::key_type>().schema;
+		const uint32_t value_schema = gGetBinaryLayout<typename T::mapped_type>().schema;
+		return { BinaryLayout::VARIABLE, 0, key_schema * 31 + value_schema };
+	}
+	else if constexpr (HasRTTI<T>)
+	{
+		const uint32_t schema = gGetSchemaHash(RTTI_OF<T>());
+
+		if constexpr (std::is_trivially_copyable_v<T>)
+		{
+			if (RTTI_OF<T>().IsTriviallySerializable())
+				return { BinaryLayout::FIXED, uint32_t(sizeof(T)), schema };
+		}
+
+		return { BinaryLayout::VARIABLE, 0, schema };
+	}
+	else if constexpr (std::is_trivially_copyable_v<T>)
+		return { BinaryLayout::FIXED, uint32_t(sizeof(T)) };
+	else
+		return { BinaryLayout::VARIABLE, 0 };
+}
+
+/* Same as gGetBinaryLayout<T>().kind == BinaryLayout::VARIABLE, without hashing the schema so it's cheap enough to check per object. */
+template<typename T>
+inline bool gHasVariableLayout()
+{
+	if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, Path>)
+		return false;
+	else if constexpr (IsVector<T>::value)
+		return !std::is_trivially_copyable_v<typename T::value_type>;
+	else if constexpr (IsMap<T>::value)
+		return true;
+	else if constexpr (HasRTTI<T>)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+			return !RTTI_OF<T>().IsTriviallySerializable();
+		else
+			return true;
+	}
+	else
+		return !std::is_trivially_copyable_v<T>;
+}
+
+/* Archived objects store their VARIABLE members with the size in bytes in front, so a reader that no longer has the member can still skip it.
+   Only the members of the archived object itself are prefixed, nested objects are part of the member holding them. */
+template<typename Fn>
+inline void gWriteSizePrefixed(ByteBuffer& ioBuffer, Fn&& inWriteFunction)
+{
+	const uint64_t start = ioBuffer.Tell();
+	WriteFileData(ioBuffer, uint64_t(0));
+
+	inWriteFunction();
+
+	const uint64_t end = ioBuffer.Tell();
+	ioBuffer.Seek(start);
+	WriteFileData(ioBuffer, uint64_t(end - start - sizeof(uint64_t)));
+	ioBuffer.Seek(end);
+}
+
+template<typename T>
+inline void WriteMemberBinary(ByteBuffer& ioBuffer, const T& inData)
+{
+	if (gHasVariableLayout<T>())
+		gWriteSizePrefixed(ioBuffer, [&]() { WriteFileBinary(ioBuffer, inData); });
+	else
+		WriteFileBinary(ioBuffer, inData);
+}
+
+template<typename T>
+inline void ReadMemberBinary(ByteBuffer& ioBuffer, T& ioData)
+{
+	// the size is only needed to skip members, reading the member itself moves past it
+	if (gHasVariableLayout<T>())
+		ioBuffer.Skip(sizeof(uint64_t));
+
+	ReadFileBinary(ioBuffer, ioData);
+}
+
+/* Moves past a value with the given layout, returns false for VARIABLE layouts which can't be skipped
+   and for arrays whose stored count is too large to be real, in both cases the position is left somewhere unknown. */
+inline bool gSkipBinary(ByteBuffer& ioBuffer, const BinaryLayout& inLayout)
+{
+	switch (inLayout.kind)
 	{
-		if (member->GetSerializeType() & SERIALIZE_BINARY)
-			member->ToBinary(ioFile, &inData);
+		case BinaryLayout::FIXED:
+		{
+			ioBuffer.Skip(inLayout.size);
+			return true;
+		}
+		case BinaryLayout::ARRAY:
+		{
+			size_t count = 0;
+			ReadFileData(ioBuffer, count);
+
+			if (inLayout.size && count > SIZE_MAX / inLayout.size)
+				return false;
+
+			ioBuffer.Skip(count * inLayout.size);
+			return true;
+		}
+		default:
+			return false;
 	}
 }
 
@@ -0,0 +1,327 @@
+#include "PCH.h"
+#include "TextureCompression.h"
+#include "Threading.h"
+#include "Timer.h"
+#include "Maths.h"
+
+namespace RK {
+
+ETextureUsage gGuessTextureUsage(const Path& inPath)
+{
+	String name = inPath.stem().string();
+	std::transform(name.begin(), name.end(), name.begin(), [](char c) { return char(std::tolower(c)); });
+
+	auto EndsWith = [&](StringView inSuffix) { return name.ends_with(inSuffix); };
+	auto Contains = [&](StringView inPart) { return name.find(inPart) != String::npos; };
+
+	if (Contains("normal") || EndsWith("_n") || EndsWith("_nrm") || EndsWith("_nor"))
+		return TEXTURE_USAGE_NORMAL;
+
+	if (Contains("rough") || Contains("metal") || Contains("occlusion") || Contains("gloss") || Contains("mask") || EndsWith("_ao") || EndsWith("_orm"))
+		return TEXTURE_USAGE_MASK;
+
+	return TEXTURE_USAGE_COLOR;
+}
+
+
+dds::DXGI_FORMAT gSelectTextureFormat(const uint8_t* inPixels, uint32_t inWidth, uint32_t inHeight, ETextureUsage inUsage)
+{
+	const size_t pixel_count = size_t(inWidth) * inHeight;
+
+	switch (inUsage)
+	{
+		case TEXTURE_USAGE_NORMAL:
+			return dds::DXGI_FORMAT_BC5_UNORM;
+
+		case TEXTURE_USAGE_MASK:
+		{
+			// a single mask stored as grayscale only needs the red channel
+			for (size_t i = 0; i < pixel_count; i++)
+			{
+				const uint8_t* pixel = inPixels + i * 4;
+				if (pixel[0] != pixel[1] || pixel[0] != pixel[2])
+					return dds::DXGI_FORMAT_BC1_UNORM;
+			}
+
+			return dds::DXGI_FORMAT_BC4_UNORM;
+		}
+
+		default:
+		{
+			for (size_t i = 0; i < pixel_count; i++)
+				if (inPixels[i * 4 + 3] != 255)
+					return dds::DXGI_FORMAT_BC3_UNORM;
+
+			return dds::DXGI_FORMAT_BC1_UNORM;
+		}
+	}
+}
+
+
+uint32_t gGetCompressedBlockSize(dds::DXGI_FORMAT inFormat)
+{
+	switch (inFormat)
+	{
+		case dds::DXGI_FORMAT_BC1_UNORM:
+		case dds::DXGI_FORMAT_BC4_UNORM:
+			return 8;
+		case dds::DXGI_FORMAT_BC3_UNORM:
+		case dds::DXGI_FORMAT_BC5_UNORM:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+
+static void sCompressBlockRows(dds::DXGI_FORMAT inFormat, const uint8_t* inPixels, uint32_t inWidth, uint32_t inHeight, uint32_t inFirstRow, uint32_t inLastRow, uint8_t* outBlocks)
+{
+	const uint32_t block_size = gGetCompressedBlockSize(inFormat);
+	const uint32_t blocks_x = ( inWidth + 3 ) / 4;
+
+	uint8_t* dst = outBlocks + size_t(inFirstRow) * blocks_x * block_size;
+
+	uint8_t block[64];
+	uint8_t channels[32];
+
+	for (uint32_t block_y = inFirstRow; block_y < inLastRow; block_y++)
+	{
+		for (uint32_t block_x = 0; block_x < blocks_x; block_x++)
+		{
+			// gather the 4x4 block, clamping to the edge for images that aren't a multiple of 4
+			for (uint32_t y = 0; y < 4; y++)
+			{
+				const uint32_t src_y = std::min(block_y * 4 + y, inHeight - 1);
+
+				for (uint32_t x = 0; x < 4; x++)
+				{
+					const uint32_t src_x = std::min(block_x * 4 + x, inWidth - 1);
+					std::memcpy(block + ( y * 4 + x ) * 4, inPixels + ( size_t(src_y) * inWidth + src_x ) * 4, 4);
+				}
+			}
+
+			switch (inFormat)
+			{
+				case dds::DXGI_FORMAT_BC1_UNORM:
+					stb_compress_dxt_block(dst, block, 0, STB_DXT_HIGHQUAL);
+					break;
+
+				case dds::DXGI_FORMAT_BC3_UNORM:
+					stb_compress_dxt_block(dst, block, 1, STB_DXT_HIGHQUAL);
+					break;
+
+				case dds::DXGI_FORMAT_BC4_UNORM:
+					for (uint32_t i = 0; i < 16; i++)
+						channels[i] = block[i * 4];
+
+					stb_compress_bc4_block(dst, channels);
+					break;
+
+				case dds::DXGI_FORMAT_BC5_UNORM:
+					for (uint32_t i = 0; i < 16; i++)
+					{
+						channels[i * 2 + 0] = block[i * 4 + 0];
+						channels[i * 2 + 1] = block[i * 4 + 1];
+					}
+
+					stb_compress_bc5_block(dst, channels);
+					break;
+
+				default:
+					assert(false);
+			}
+
+			dst += block_size;
+		}
+	}
+}
+
+
+void gCompressTexture(dds::DXGI_FORMAT inFormat, const uint8_t* inPixels, uint32_t inWidth, uint32_t inHeight, uint8_t* outBlocks)
+{
+	assert(gGetCompressedBlockSize(inFormat) > 0);
+
+	const uint32_t blocks_x = ( inWidth + 3 ) / 4;
+	const uint32_t blocks_y = ( inHeight + 3 ) / 4;
+
+	// a few hundred blocks per job, small mips end up as a single job
+	const uint32_t rows_per_job = std::max(256u / blocks_x, 1u);
+
+	if (blocks_y <= rows_per_job)
+	{
+		sCompressBlockRows(inFormat, inPixels, inWidth, inHeight, 0, blocks_y, outBlocks);
+		return;
+	}
+
+	Array<Job::Ptr> jobs;
+	jobs.reserve(( blocks_y + rows_per_job - 1 ) / rows_per_job);
+
+	for (uint32_t first_row = 0; first_row < blocks_y; first_row += rows_per_job)
+	{
+		const uint32_t last_row = std::min(first_row + rows_per_job, blocks_y);
+
+		jobs.push_back(g_ThreadPool.QueueJob([=]()
+		{
+			sCompressBlockRows(inFormat, inPixels, inWidth, inHeight, first_row, last_row, outBlocks);
+		}));
+	}
+
+	// Convert itself runs on workers that may all be busy compressing other textures, WaitForJob compresses the rows nobody picked up yet on this thread
+	for (const Job::Ptr& job : jobs)
+		g_ThreadPool.WaitForJob(job);
+}
+
+
+static stbir_filter sGetResizeFilter(EMipFilter inFilter)
+{
+	switch (inFilter)
+	{
+		case MIP_FILTER_BOX: return STBIR_FILTER_BOX;
+		case MIP_FILTER_TRIANGLE: return STBIR_FILTER_TRIANGLE;
+		case MIP_FILTER_CATMULL_ROM: return STBIR_FILTER_CATMULLROM;
+		default: return STBIR_FILTER_MITCHELL;
+	}
+}
+
+
+static void sResample(const MipLevel& inSrc, MipLevel& ioDst, bool inIsSRGB, EMipFilter inFilter)
+{
+	ioDst.pixels.resize(size_t(ioDst.width) * ioDst.height * 4);
+
+	// RGBA weighs color by alpha so transparent texels don't bleed into their neighbours
+	STBIR_RESIZE resize;
+	stbir_resize_init(&resize, inSrc.pixels.data(), inSrc.width, inSrc.height, 0, ioDst.pixels.data(), ioDst.width, ioDst.height, 0,
+		inIsSRGB ? STBIR_RGBA : STBIR_4CHANNEL, inIsSRGB ? STBIR_TYPE_UINT8_SRGB : STBIR_TYPE_UINT8);
+
+	// material textures tile, so wrap instead of clamping
+	stbir_set_edgemodes(&resize, STBIR_EDGE_WRAP, STBIR_EDGE_WRAP);
+	stbir_set_filters(&resize, sGetResizeFilter(inFilter), sGetResizeFilter(inFilter));
+
+	// stb_image_resize does the SIMD, we split the output into horizontal tiles across the thread pool
+	const int split_count = stbir_build_samplers_with_splits(&resize, int(std::min(ioDst.height / 16 + 1, g_ThreadPool.GetThreadCount() + 1)));
+
+	Array<Job::Ptr> jobs;
+
+	for (int split = 1; split < split_count; split++)
+		jobs.push_back(g_ThreadPool.QueueJob([&resize, split]() { stbir_resize_extended_split(&resize, split, 1); }));
+
+	stbir_resize_extended_split(&resize, 0, 1);
+
+	for (const Job::Ptr& job : jobs)
+		g_ThreadPool.WaitForJob(job);
+
+	stbir_free_samplers(&resize);
+}
+
+
+static void sRenormalize(MipLevel& ioLevel)
+{
+	for (size_t i = 0; i < ioLevel.pixels.size(); i += 4)
+	{
+		uint8_t* pixel = ioLevel.pixels.data() + i;
+
+		const Vec3 normal = glm::normalize(Vec3(pixel[0], pixel[1], pixel[2]) / 127.5f - 1.0f);
+		const Vec3 encoded = glm::round(( normal * 0.5f + 0.5f ) * 255.0f);
+
+		pixel[0] = uint8_t(encoded.x);
+		pixel[1] = uint8_t(encoded.y);
+		pixel[2] = uint8_t(encoded.z);
+	}
+}
+
+
+Array<MipLevel> gGenerateMipChain(const uint8_t* inPixels, uint32_t inWidth, uint32_t inHeight, ETextureUsage inUsage, EMipFilter inFilter)
+{
+	const bool is_srgb = inUsage == TEXTURE_USAGE_COLOR;
+
+	Array<MipLevel> mips;
+	mips.reserve(32);
+
+	MipLevel& mip0 = mips.emplace_back();
+	mip0.width = uint32_t(gAlignUp(inWidth, 4));
+	mip0.height = uint32_t(gAlignUp(inHeight, 4));
+
+	if (mip0.width == inWidth && mip0.height == inHeight)
+	{
+		mip0.pixels.assign(inPixels, inPixels + size_t(inWidth) * inHeight * 4);
+	}
+	else
+	{
+		// at most a 3 texel stretch, padding instead would shift the UVs
+		const MipLevel source = { inWidth, inHeight, Array<uint8_t>(inPixels, inPixels + size_t(inWidth) * inHeight * 4) };
+		sResample(source, mip0, is_srgb, inFilter);
+	}
+
+	while (mips.back().width > 1 || mips.back().height > 1)
+	{
+		const MipLevel& prev = mips.back();
+
+		MipLevel mip;
+		mip.width = std::max(prev.width / 2, 1u);
+		mip.height = std::max(prev.height / 2, 1u);
+
+		sResample(prev, mip, is_srgb, inFilter);
+
+		if (inUsage == TEXTURE_USAGE_NORMAL)
+			sRenormalize(mip);
+
+		mips.push_back(std::move(mip));
+	}
+
+	return mips;
+}
+
+
+void RunTextureCompressionBenchmark()
+{
+	constexpr uint32_t width = 2048;
+	constexpr uint32_t height = 2048;
+
+	// smooth gradients with some noise on top, roughly what photo sourced textures look like to the encoder
+	Array<uint8_t> pixels(width * height * 4);
+	uint32_t seed = 0x9E3779B9;
+
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+			const uint8_t noise = uint8_t(seed & 15);
+
+			uint8_t* pixel = pixels.data() + ( y * width + x ) * 4;
+			pixel[0] = uint8_t(( x * 255 ) / width) ^ noise;
+			pixel[1] = uint8_t(( y * 255 ) / height) ^ noise;
+			pixel[2] = uint8_t(( ( x + y ) * 127 ) / width) ^ noise;
+			pixel[3] = uint8_t(255 - noise);
+		}
+	}
+
+	constexpr StaticArray<Pair<dds::DXGI_FORMAT, const char*>, 4> formats =
+	{
+		Pair<dds::DXGI_FORMAT, const char*> { dds::DXGI_FORMAT_BC1_UNORM, "BC1" },
+		Pair<dds::DXGI_FORMAT, const char*> { dds::DXGI_FORMAT_BC3_UNORM, "BC3" },
+		Pair<dds::DXGI_FORMAT, const char*> { dds::DXGI_FORMAT_BC4_UNORM, "BC4" },
+		Pair<dds::DXGI_FORMAT, const char*> { dds::DXGI_FORMAT_BC5_UNORM, "BC5" }
+	};
+
+	{
+		Timer timer;
+		const Array<MipLevel> mips = gGenerateMipChain(pixels.data(), width, height, TEXTURE_USAGE_COLOR);
+		const float seconds = timer.GetElapsedTime();
+
+		std::cout << std::format("[Benchmark] Mip generation: {} levels in {:.3f} ms, {:.1f} MPix/s\n", mips.size(), Timer::sToMilliseconds(seconds), ( width * height ) / ( seconds * 1'000'000.0f ));
+	}
+
+	Array<uint8_t> blocks(( width / 4 ) * ( height / 4 ) * 16);
+
+	for (const auto& [format, name] : formats)
+	{
+		Timer timer;
+		gCompressTexture(format, pixels.data(), width, height, blocks.data());
+		const float seconds = timer.GetElapsedTime();
+
+		std::cout << std::format("[Benchmark] Texture compression {}: {:.3f} ms, {:.1f} MPix/s\n", name, Timer::sToMilliseconds(seconds), ( width * height ) / ( seconds * 1'000'000.0f ));
+	}
+}
+
+} // namespace RK
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "DDS.h"
+
+namespace RK {
+
+enum ETextureUsage
+{
+	TEXTURE_USAGE_AUTO,		// guessed from the file name
+	TEXTURE_USAGE_COLOR,	// BC1, or BC3 if any pixel has alpha
+	TEXTURE_USAGE_NORMAL,	// BC5, Z is reconstructed in the shader
+	TEXTURE_USAGE_MASK		// BC4 if it's single channel, BC1 if it packs multiple masks (e.g. GLTF's metallic roughness)
+};
+
+enum EMipFilter
+{
+	MIP_FILTER_BOX,
+	MIP_FILTER_TRIANGLE,
+	MIP_FILTER_MITCHELL,
+	MIP_FILTER_CATMULL_ROM
+};
+
+struct MipLevel
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	Array<uint8_t> pixels; // RGBA8
+};
+
+
+/* Guesses usage from common file name conventions (_normal, _roughness, etc.), defaults to TEXTURE_USAGE_COLOR. */
+ETextureUsage gGuessTextureUsage(const Path& inPath);
+
+/* Picks the block compressed format for inPixels (RGBA8) given its usage. */
+dds::DXGI_FORMAT gSelectTextureFormat(const uint8_t* inPixels, uint32_t inWidth, uint32_t inHeight, ETextureUsage inUsage);
+
+/* Bytes per 4x4 block, 0 for formats we can't compress to. */
+uint32_t gGetCompressedBlockSize(dds::DXGI_FORMAT inFormat);
+
+/* Compresses inPixels (RGBA8, any size) to inFormat, rows of blocks are spread across the thread pool.
+	Partial blocks at the edges replicate the last row/column. outBlocks should hold ceil(w/4) * ceil(h/4) blocks. */
+void gCompressTexture(dds::DXGI_FORMAT inFormat, const uint8_t* inPixels, uint32_t inWidth, uint32_t inHeight, uint8_t* outBlocks);
+
+/* Builds the full mip chain for inPixels (RGBA8) down to 1x1, level 0 included. Level 0 is only resampled if it's not a multiple
+	of 4 (a D3D12 requirement for block compressed textures), smaller levels can be any size as partial blocks get padded.
+	Color textures are filtered in linear space, normal maps are renormalized. Levels are split into tiles across the thread pool. */
+Array<MipLevel> gGenerateMipChain(const uint8_t* inPixels, uint32_t inWidth, uint32_t inHeight, ETextureUsage inUsage, EMipFilter inFilter = MIP_FILTER_MITCHELL);
+
+void RunTextureCompressionBenchmark();
+
+} // namespace RK
@@ -66,6 +66,20 @@ void ThreadPool::WaitForJobs()
 }
 
 
+void ThreadPool::WaitForJob(const JobPtr& inJob)
+{
+	// it stays in the queue, the worker that pops it skips running it but still counts it as done
+	if (inJob->Claim())
+	{
+		inJob->Run();
+		return;
+	}
+
+	while (!inJob->IsFinished())
+		std::this_thread::yield();
+}
+
+
 void ThreadPool::Shutdown()
 {
 	// let every thread know they can exit their while loops
@@ -107,7 +121,9 @@ void ThreadPool::ThreadLoop(uint32_t inThreadIndex)
 
 			lock.unlock();
 
-			job->Run();
+			// WaitForJob might have run it already
+			if (job->Claim())
+				job->Run();
 
 			// re-lock so wait doesn't unlock an unlocked mutex
 			lock.lock();
@@ -11,6 +11,10 @@ public:
 	Job(const Function& inFunction) : m_Function(inFunction) {}
 	void Run() { m_Function(); m_Finished = true; }
 	void WaitCPU() const { while (!m_Finished) {} }
+	bool IsFinished() const { return m_Finished; }
+
+	/* True for exactly one caller, whoever gets it runs the job. Lets WaitForJob run a job that's still sitting in the queue. */
+	bool Claim() { return !m_Claimed.exchange(true); }
 
 	class Barrier
 	{
@@ -25,6 +29,7 @@ public:
 
 private:
 	Function m_Function;
+	Atomic<bool> m_Claimed = false;
 	Atomic<bool> m_Finished = false;
 };
 
@@ -45,6 +50,10 @@ public:
 	/* Wait for all jobs to finish. */
 	void WaitForJobs();
 
+	/* Wait for a single job. If no thread picked it up yet it runs on the calling thread, so jobs can wait on jobs they queued
+		themselves without starving the pool. Never runs any other job, so the calling thread (e.g. the main thread) only ever runs the job it waits on. */
+	void WaitForJob(const JobPtr& inJob);
+
 	/* exits all the threads. */
 	void Shutdown();
 
@@ -53,13 +53,13 @@ template<typename T> requires ( sizeof(T) < 1024 && std::default_initializable<T
 
     void Undo(Scene& inScene) override
     {
-        T& component = inScene.Get<T>(entity);
+        T& component = inScene.GetMutable<T>(entity);
         component = previous;
     }
 
     void Redo(Scene& inScene) override
     {
-        T& component = inScene.Get<T>(entity);
+        T& component = inScene.GetMutable<T>(entity);
         component = current;
     }
 };
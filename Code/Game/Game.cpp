@@ -86,6 +86,9 @@ GameApp::GameApp() :
 
     LogMessage(std::format("[CPU] Shader compilation took {:.2f} ms", Timer::sToMilliseconds(timer.Restart())));
 
+    // Level bundles take precedence over loose files
+    m_Assets.MountBundles("Cached/Bundles");
+
     // Create default textures / assets
     const String black_texture_file = "Assets/black4x4.dds";
     const String white_texture_file = "Assets/white4x4.dds";
@@ -144,6 +147,9 @@ void GameApp::OnUpdate(float inDeltaTime)
     // update relative mouse mode
     SDL_SetWindowRelativeMouseMode(m_Window, g_Input->IsRelativeMouseMode());
 
+    // swap in and upload any scene that is being streamed in
+    m_Scene.UpdateStreaming();
+
     // update the physics system
     m_Physics.OnUpdate(m_Scene);
 